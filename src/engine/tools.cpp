@@ -580,6 +580,39 @@ bool LoadFileToMem(std::vector<u8> & data, const std::string & file)
     return false;
 }
 
+namespace
+{
+    /* filled on the static init, before any thread */
+    struct CheckSumTable
+    {
+	CheckSumTable()
+	{
+	    for(u32 ii = 0; ii < 256; ++ii)
+	    {
+		u32 crc = ii;
+		for(u8 jj = 0; jj < 8; ++jj)
+		    crc = crc & 1 ? 0xEDB88320 ^ (crc >> 1) : crc >> 1;
+		table[ii] = crc;
+	    }
+	}
+
+	u32 table[256];
+    };
+
+    const CheckSumTable crc32;
+}
+
+/* crc32 */
+u32 CheckSum(const char* data, size_t size)
+{
+    u32 crc = 0xFFFFFFFF;
+
+    for(size_t ii = 0; ii < size; ++ii)
+	crc = crc32.table[(crc ^ static_cast<u8>(data[ii])) & 0xFF] ^ (crc >> 8);
+
+    return crc ^ 0xFFFFFFFF;
+}
+
 bool PressIntKey(u32 min, u32 max, u32 & result)
 {
     LocalEvent & le = LocalEvent::Get();
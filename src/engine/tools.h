@@ -63,6 +63,8 @@ u32 GetMemoryUsage(void);
 bool SaveMemToFile(const std::vector<u8> &, const std::string &);
 bool LoadFileToMem(std::vector<u8> &, const std::string &);
 
+u32 CheckSum(const char*, size_t);
+
 std::string EncodeString(const std::string & str, const char* charset);
 
 void ToolsSrcRectFixed(Rect &, s16 &, s16 &, const u16, const u16, const Rect &);
@@ -44,6 +44,9 @@ namespace AI
 
     void Init(void);
 
+    void WorldObjectChanged(const s32 &, u8 colors);
+
+    void KingdomsPlan(bool threads = true);
     void KingdomTurn(Kingdom &);
     void BattleTurn(Battle::Arena &, const Battle::Unit &, Battle::Actions &);
     bool BattleMagicTurn(Battle::Arena &, const Battle::Unit &, Battle::Actions &, const Battle::Unit*);
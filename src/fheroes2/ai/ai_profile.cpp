@@ -0,0 +1,185 @@
+/***************************************************************************
+ *   Copyright (C) 2010 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifdef WITH_PROFILE
+#include <map>
+#include <fstream>
+#include <sys/time.h>
+#include "color.h"
+#include "world.h"
+#include "settings.h"
+#include "ai_profile.h"
+
+namespace
+{
+    struct Counter
+    {
+	Counter() : count(0), usec(0) {}
+
+	u32	count;
+	double	usec;
+    };
+
+    struct Counters
+    {
+	Counter	phases[KINGDOMMAX + 1][AI::Profile::PHASE_COUNT];
+    };
+
+    // by day
+    std::map<u16, Counters>	profile;
+    u8				kingdom = Color::NONE;
+
+    u32 GetMicroSeconds(void)
+    {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+    }
+
+    void WriteCSV(std::ostream & os, const std::string & day, const Counters & counters)
+    {
+	for(u8 col = Color::BLUE; col <= Color::PURPLE; col <<= 1)
+	    for(u8 phase = 0; phase < AI::Profile::PHASE_COUNT; ++phase)
+	{
+	    const Counter & cn = counters.phases[Color::GetIndex(col)][phase];
+
+	    if(cn.count)
+		os << day << "," << Color::String(col) << "," <<
+		    AI::Profile::String(static_cast<AI::Profile::phase_t>(phase)) << "," <<
+		    cn.count << "," << static_cast<u32>(cn.usec) << std::endl;
+	}
+    }
+
+    void WriteJSON(std::ostream & os, const Counters & counters)
+    {
+	bool first1 = true;
+	os << "{";
+
+	for(u8 col = Color::BLUE; col <= Color::PURPLE; col <<= 1)
+	{
+	    bool first2 = true;
+
+	    for(u8 phase = 0; phase < AI::Profile::PHASE_COUNT; ++phase)
+	    {
+		const Counter & cn = counters.phases[Color::GetIndex(col)][phase];
+		if(! cn.count) continue;
+
+		if(first2)
+		{
+		    os << (first1 ? "" : ",") << "\"" << Color::String(col) << "\":{";
+		    first1 = false;
+		    first2 = false;
+		}
+		else
+		    os << ",";
+
+		os << "\"" << AI::Profile::String(static_cast<AI::Profile::phase_t>(phase)) << "\":{" <<
+		    "\"count\":" << cn.count << ",\"usec\":" << static_cast<u32>(cn.usec) << "}";
+	    }
+
+	    if(! first2) os << "}";
+	}
+
+	os << "}";
+    }
+}
+
+AI::Profile::Timer::Timer(phase_t p) : phase(p), start(GetMicroSeconds())
+{
+}
+
+AI::Profile::Timer::~Timer()
+{
+    if(Color::NONE == kingdom) return;
+
+    Counter & cn = profile[world.CountDay()].phases[Color::GetIndex(kingdom)][phase];
+
+    cn.count += 1;
+    cn.usec += GetMicroSeconds() - start;
+}
+
+const char* AI::Profile::String(phase_t phase)
+{
+    const char* str_phase[] = { "scan", "castles", "recruit", "heroes task", "heroes move", "battle", "path", "unknown" };
+    return str_phase[phase < PHASE_COUNT ? phase : PHASE_COUNT];
+}
+
+void AI::Profile::SetKingdom(u8 color)
+{
+    kingdom = color;
+}
+
+void AI::Profile::Reset(void)
+{
+    profile.clear();
+    kingdom = Color::NONE;
+}
+
+bool AI::Profile::Save(const std::string & file)
+{
+    std::ofstream os(file.c_str());
+    if(! os.is_open()) return false;
+
+    const bool csv = 4 < file.size() && file.substr(file.size() - 4) == ".csv";
+    Counters total;
+
+    for(std::map<u16, Counters>::const_iterator
+	it = profile.begin(); it != profile.end(); ++it)
+	for(u8 index = 0; index < KINGDOMMAX + 1; ++index)
+	    for(u8 phase = 0; phase < PHASE_COUNT; ++phase)
+    {
+	total.phases[index][phase].count += (*it).second.phases[index][phase].count;
+	total.phases[index][phase].usec += (*it).second.phases[index][phase].usec;
+    }
+
+    if(csv)
+    {
+	os << "day,color,phase,count,usec" << std::endl;
+
+	for(std::map<u16, Counters>::const_iterator
+	    it = profile.begin(); it != profile.end(); ++it)
+	    WriteCSV(os, GetString((*it).first), (*it).second);
+
+	WriteCSV(os, "total", total);
+    }
+    else
+    {
+	os << "{\"days\":[";
+
+	for(std::map<u16, Counters>::const_iterator
+	    it = profile.begin(); it != profile.end(); ++it)
+	{
+	    os << (it != profile.begin() ? "," : "") << "{\"day\":" << (*it).first << ",\"kingdoms\":";
+	    WriteJSON(os, (*it).second);
+	    os << "}";
+	}
+
+	os << "],\"total\":";
+	WriteJSON(os, total);
+	os << "}" << std::endl;
+    }
+
+    DEBUG(DBG_AI, DBG_INFO, "save: " << file);
+
+    return true;
+}
+#endif
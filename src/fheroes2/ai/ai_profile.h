@@ -0,0 +1,78 @@
+/***************************************************************************
+ *   Copyright (C) 2010 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef H2AI_PROFILE_H
+#define H2AI_PROFILE_H
+
+#include <string>
+#include "gamedefs.h"
+
+namespace AI
+{
+    namespace Profile
+    {
+	enum phase_t
+	{
+	    SCAN,
+	    CASTLES,
+	    RECRUIT,
+	    HEROES_TASK,
+	    HEROES_MOVE,
+	    BATTLE,
+	    PATH,
+	    PHASE_COUNT
+	};
+
+	/* scoped timer: inclusive time of the phase for the current AI kingdom */
+	class Timer
+	{
+	    public:
+		Timer(phase_t);
+		~Timer();
+
+	    private:
+		phase_t	phase;
+		u32	start;
+	};
+
+	const char* String(phase_t);
+
+	void	SetKingdom(u8 color);	// Color::NONE: out of the AI turn
+	void	Reset(void);
+	bool	Save(const std::string &);	// json, or csv by extension
+    }
+}
+
+/* compile time switch: without WITH_PROFILE the instrumentation is empty */
+#ifdef WITH_PROFILE
+#define AI_PROFILE(phase)		AI::Profile::Timer ai_profile_timer(AI::Profile::phase)
+#define AI_PROFILE_KINGDOM(color)	AI::Profile::SetKingdom(color)
+#define AI_PROFILE_RESET()		AI::Profile::Reset()
+#define AI_PROFILE_SAVE(file)		AI::Profile::Save(file)
+#else
+#define AI_PROFILE(phase)
+#define AI_PROFILE_KINGDOM(color)
+#define AI_PROFILE_RESET()
+#define AI_PROFILE_SAVE(file)
+#endif
+
+#endif
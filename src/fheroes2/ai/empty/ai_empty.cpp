@@ -47,6 +47,14 @@ void AI::Init(void)
 {
 }
 
+void AI::WorldObjectChanged(const s32 &, u8)
+{
+}
+
+void AI::KingdomsPlan(bool)
+{
+}
+
 void AI::CastlePreBattle(Castle &)
 {
 }
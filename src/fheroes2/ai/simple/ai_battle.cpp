@@ -38,6 +38,7 @@
 #include "battle_troop.h"
 #include "battle_interface.h"
 #include "battle_command.h"
+#include "battle_spelltarget.h"
 #include "ai_simple.h"
 
 namespace Battle
@@ -48,32 +49,6 @@ namespace Battle
     s16		AIMaxQualityPosition(const Indexes &);
     const Unit* AIGetEnemyAbroadMaxQuality(s16, u8 color);
     const Unit* AIGetEnemyAbroadMaxQuality(const Unit &);
-    s16		AIAreaSpellDst(const HeroBase &);
-
-    bool MaxDstCount(const std::pair<s16, u8> & p1, const std::pair<s16, u8> & p2) { return p1.second < p2.second; }
-}
-
-s16 Battle::AIAreaSpellDst(const HeroBase & hero)
-{
-    std::map<s16, u8> dstcount;
-
-    Arena* arena = GetArena();
-    Units enemies(arena->GetForce(hero.GetColor(), true), true);
-
-    for(Units::const_iterator
-	it1 = enemies.begin(); it1 != enemies.end(); ++it1)
-    {
-	const Indexes around = Board::GetAroundIndexes(**it1);
-
-	for(Indexes::const_iterator
-	    it2 = around.begin(); it2 != around.end(); ++it2)
-	    dstcount[*it2] += 1;
-    }
-
-    // find max
-    std::map<s16, u8>::const_iterator max = std::max_element(dstcount.begin(), dstcount.end(), MaxDstCount);
-
-    return max != dstcount.end() ? (*max).first : -1;
 }
 
 s16 Battle::AIMaxQualityPosition(const Indexes & positions)
@@ -177,7 +152,7 @@ s16 Battle::AIAttackPosition(Arena & arena, const Unit & b, const Indexes & posi
         Indexes results;
         results.reserve(12);
 
-	const Units enemies(arena.GetForce(b.GetColor(), true), true);
+	const Units & enemies = arena.GetForce(b.GetColor(), true).GetValidUnits();
 
 	if(1 < enemies.size())
 	{
@@ -377,17 +352,15 @@ bool AI::BattleMagicTurn(Arena & arena, const Unit & b, Actions & a, const Unit*
 
     // area damage spell
     {
-	const u8 areasp[] = { Spell::METEORSHOWER, Spell::FIREBLAST, Spell::CHAINLIGHTNING, Spell::FIREBALL, Spell::COLDRING };
-	s16 dst = AIAreaSpellDst(*hero);
+	const u8 areasp[] = { Spell::METEORSHOWER, Spell::FIREBLAST, Spell::CHAINLIGHTNING, Spell::FIREBALL, Spell::COLDRING,
+				Spell::ARMAGEDDON, Spell::ELEMENTALSTORM };
+	SpellEvaluator evaluator(*hero);
+	const SpellTarget target = evaluator.GetBest(areasp, ARRAY_COUNT(areasp));
 
-	if(Board::isValidIndex(dst))
-	for(u8 ii = 0; ii < ARRAY_COUNT(areasp); ++ii)
+	if(0 < target.value)
 	{
-	    if(hero->CanCastSpell(areasp[ii]))
-	    {
-		a.push_back(Battle::Command(MSG_BATTLE_CAST, areasp[ii], dst));
-		return true;
-	    }
+	    a.push_back(Battle::Command(MSG_BATTLE_CAST, target.spell(), target.dst));
+	    return true;
 	}
     }
 
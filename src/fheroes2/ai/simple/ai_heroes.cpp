@@ -48,8 +48,10 @@
 #include "interface_gamearea.h"
 #include "maps_tiles.h"
 #include "ai_simple.h"
+#include "ai_profile.h"
 
 #define HERO_MAX_SHEDULED_TASK 7
+#define HERO_DISTANCE_FIELD_DAYS 5
 
 AIHeroes & AIHeroes::Get(void)
 {
@@ -73,6 +75,9 @@ void AIHero::Reset(void)
     primary_target = -1;
     sheduled_visit.clear();
     fix_loop = 0;
+    tasks.clear();
+    tasks_tiles.clear();
+    tasks_field = MAXU32;
 }
 
 bool AI::HeroesSkipFog(void)
@@ -104,6 +109,12 @@ std::string AI::HeroesString(const Heroes & hero)
 	os << *it << "(" << MP2::StringObject(world.GetTiles(*it).GetObject()) << "), ";
     os << std::endl;
 
+    os << "ai planned tasks : ";
+    for(std::vector<IndexDistance>::const_iterator
+	it = ai_hero.tasks.begin(); it != ai_hero.tasks.end(); ++it)
+	os << (*it).first << "(" << (*it).second << "), ";
+    os << std::endl;
+
     return os.str();
 }
 
@@ -195,8 +206,36 @@ bool AIHeroesPriorityObject(const Heroes & hero, s32 index)
     return false;
 }
 
+void AIHeroesPlanField(const Heroes & hero, AIHero & ai_hero)
+{
+    const u32 limit = HERO_DISTANCE_FIELD_DAYS * hero.GetMaxMovePoints();
+
+    ai_hero.field.Calculate(hero, MAXU16 < limit ? MAXU16 : limit);
+    ai_hero.field_serial = AIWorldChanges().size();
+    ai_hero.field_count++;
+}
+
+/* per hero and turn: reused while the hero stays on the place and the world around is not changed */
+const Route::DistanceField & AIHeroesDistanceField(const Heroes & hero)
+{
+    AIHero & ai_hero = AIHeroes::Get(hero);
+    const std::vector<s32> & changes = AIWorldChanges();
+    bool valid = ai_hero.field.isValid(hero) && ai_hero.field_serial <= changes.size();
+
+    for(u32 ii = ai_hero.field_serial; valid && ii < changes.size(); ++ii)
+	if(ai_hero.field.isAffected(changes[ii])) valid = false;
+
+    if(valid)
+	ai_hero.field_serial = changes.size();
+    else
+	AIHeroesPlanField(hero, ai_hero);
+
+    return ai_hero.field;
+}
+
 s32  FindUncharteredTerritory(Heroes & hero, const u8 & scoute)
 {
+    const Route::DistanceField & field = AIHeroesDistanceField(hero);
     Maps::Indexes v = Maps::GetAroundIndexes(hero.GetIndex(), scoute, true);
     Maps::Indexes res;
 
@@ -217,7 +256,7 @@ s32  FindUncharteredTerritory(Heroes & hero, const u8 & scoute)
 	// find fogs
 	if(world.GetTiles(*it).isFog(hero.GetColor()) &&
     	    world.GetTiles(*it).isPassable(&hero, Direction::CENTER, true) &&
-	    hero.GetPath().Calculate(*it))
+	    (field.isReachable(*it) || (!field.isComplete() && hero.GetPath().Calculate(*it))))
 	    res.push_back(*it);
     }
 
@@ -234,6 +273,7 @@ s32  FindUncharteredTerritory(Heroes & hero, const u8 & scoute)
 
 s32  GetRandomHeroesPosition(Heroes & hero, const u8 & scoute)
 {
+    const Route::DistanceField & field = AIHeroesDistanceField(hero);
     Maps::Indexes v = Maps::GetAroundIndexes(hero.GetIndex(), scoute, true);
     Maps::Indexes res;
 
@@ -251,7 +291,7 @@ s32  GetRandomHeroesPosition(Heroes & hero, const u8 & scoute)
 #endif
     {
         if(world.GetTiles(*it).isPassable(&hero, Direction::CENTER, true) &&
-	    hero.GetPath().Calculate(*it))
+	    (field.isReachable(*it) || (!field.isComplete() && hero.GetPath().Calculate(*it))))
 	    res.push_back(*it);
     }
 
@@ -306,16 +346,17 @@ void AIHeroesAddedRescueTask(Heroes & hero)
     if(0 <= index) task.push_back(index);
 }
 
-void AIHeroesAddedTask(Heroes & hero)
+/* read only for the world: the task candidates by the hero field, see AI::KingdomsPlan */
+void AIHeroesPlanTasks(const Heroes & hero, AIHero & ai_hero, const AIKingdom & ai_kingdom)
 {
-    AIHero & ai_hero = AIHeroes::Get(hero);
-    AIKingdom & ai_kingdom = AIKingdoms::Get(hero.GetColor());
+    const IndexObjectMap & ai_objects = ai_kingdom.scans;
 
-    Queue & task = ai_hero.sheduled_visit;
-    IndexObjectMap & ai_objects = ai_kingdom.scans;
+    // load minimal distance tasks: movement cost, and outside the field the approximate distance
+    const Route::DistanceField & field = ai_hero.field;
+    std::vector<IndexDistance> & objs = ai_hero.tasks;
+    std::vector<IndexDistance> others;
 
-    // load minimal distance tasks
-    std::vector<IndexDistance> objs;
+    objs.clear();
     objs.reserve(ai_objects.size());
 
     for(std::map<s32, MP2::object_t>::const_iterator
@@ -336,23 +377,90 @@ void AIHeroesAddedTask(Heroes & hero)
 	    if(tile.isWater() && MP2::OBJ_BOAT != tile.GetObject()) continue;
 	}
 
-	objs.push_back(IndexDistance((*it).first,
+	if(field.isReachable((*it).first))
+	    objs.push_back(IndexDistance((*it).first, field.Get((*it).first)));
+	else
+	// unreachable, if the field is complete
+	if(! field.isComplete())
+	    others.push_back(IndexDistance((*it).first,
 			    Maps::GetApproximateDistance(hero.GetIndex(), (*it).first)));
     }
 
     DEBUG(DBG_AI, DBG_INFO, Color::String(hero.GetColor()) <<
-		    ", hero: " << hero.GetName() << ", task prepare: " << objs.size());
+		    ", hero: " << hero.GetName() << ", task prepare: " << objs.size() << ", others: " << others.size());
 
-    std::sort(objs.begin(), objs.end(), IndexDistance::Shortest);
+    // stable: the order does not depend on the objects taken by the other heroes
+    std::stable_sort(objs.begin(), objs.end(), IndexDistance::Shortest);
+    std::stable_sort(others.begin(), others.end(), IndexDistance::Shortest);
+
+    ai_hero.tasks_reachable = objs.size();
+    objs.insert(objs.end(), others.begin(), others.end());
+    ai_hero.tasks_field = ai_hero.field_count;
+    ai_hero.tasks_serial = AIWorldChanges().size();
+
+    std::vector<s32> & tiles = ai_hero.tasks_tiles;
+    tiles.clear();
+    tiles.reserve(objs.size());
+    for(std::vector<IndexDistance>::const_iterator
+	it = objs.begin(); it != objs.end(); ++it)
+	tiles.push_back((*it).first);
+    std::sort(tiles.begin(), tiles.end());
+}
+
+/* the world changes after the plan: the changed candidate or the new object, which may be the candidate */
+bool AIHeroesTasksAffected(const AIHero & ai_hero, const AIKingdom & ai_kingdom)
+{
+    const std::vector<s32> & changes = AIWorldChanges();
+    const Route::DistanceField & field = ai_hero.field;
+
+    // planned with other field
+    if(ai_hero.tasks_field != ai_hero.field_count ||
+	ai_hero.tasks_serial > changes.size()) return true;
+
+    for(u32 ii = ai_hero.tasks_serial; ii < changes.size(); ++ii)
+    {
+	const s32 & index = changes[ii];
+
+	// the removed object is skipped by the task validation
+	if(ai_kingdom.scans.end() == ai_kingdom.scans.find(index)) continue;
+
+	if(std::binary_search(ai_hero.tasks_tiles.begin(), ai_hero.tasks_tiles.end(), index) ||
+	    field.isReachable(index) || ! field.isComplete()) return true;
+    }
+
+    return false;
+}
+
+void AIHeroesAddedTask(Heroes & hero)
+{
+    AIHero & ai_hero = AIHeroes::Get(hero);
+    AIKingdom & ai_kingdom = AIKingdoms::Get(hero.GetColor());
+
+    Queue & task = ai_hero.sheduled_visit;
+    IndexObjectMap & ai_objects = ai_kingdom.scans;
+
+    AIHeroesDistanceField(hero);
+
+    if(AIHeroesTasksAffected(ai_hero, ai_kingdom))
+	AIHeroesPlanTasks(hero, ai_hero, ai_kingdom);
+    else
+	ai_hero.tasks_serial = AIWorldChanges().size();
+
+    const std::vector<IndexDistance> & objs = ai_hero.tasks;
+    const std::vector<IndexDistance>::const_iterator first_other = objs.begin() + ai_hero.tasks_reachable;
 
     for(std::vector<IndexDistance>::const_iterator
 	it = objs.begin(); it != objs.end(); ++it)
     {
 	if(task.size() >= HERO_MAX_SHEDULED_TASK) break;
+
+	// taken by the other hero
+	if(ai_objects.end() == ai_objects.find((*it).first)) continue;
+
 	const bool validobj = AI::HeroesValidObject(hero, (*it).first);
 
 	if(validobj &&
-	    hero.GetPath().Calculate((*it).first))
+	    (it < first_other || hero.GetPath().Calculate((*it).first)))
 	{
 	    DEBUG(DBG_AI, DBG_INFO, Color::String(hero.GetColor()) <<
 		    ", hero: " << hero.GetName() << ", added tasks: " <<
@@ -691,14 +799,20 @@ void AI::HeroesTurn(Heroes & hero)
         //if(status) status->RedrawTurnProgress(4);
 
         // get task for heroes
-        AI::HeroesGetTask(hero);
+        {
+	    AI_PROFILE(HEROES_TASK);
+	    AI::HeroesGetTask(hero);
+	}
 
         // turn indicator
         if(status) status->RedrawTurnProgress(5);
         //if(status) status->RedrawTurnProgress(6);
 
         // heroes AI turn
-        AI::HeroesMove(hero);
+        {
+	    AI_PROFILE(HEROES_MOVE);
+	    AI::HeroesMove(hero);
+	}
 
 	// turn indicator
         if(status) status->RedrawTurnProgress(7);
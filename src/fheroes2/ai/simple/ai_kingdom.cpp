@@ -42,6 +42,7 @@
 #include "agg.h"
 #include "ai.h"
 #include "ai_simple.h"
+#include "ai_profile.h"
 
 void AICastleTurn(Castle*);
 void AIHeroesTurn(Heroes*);
@@ -70,6 +71,8 @@ void AIKingdom::Reset(void)
 {
     capital = NULL;
     scans.clear();
+    changes.clear();
+    scanned = false;
 }
 
 void IndexObjectMap::DumpObjects(const IndexDistance & id)
@@ -81,47 +84,178 @@ void IndexObjectMap::DumpObjects(const IndexDistance & id)
 			<< ", maps index: " << id.first << ", dist: " << id.second);
 }
 
-void WorldStoreObjects(u8 color, IndexObjectMap & store)
+bool WorldStoreObject(u8 color, s32 index)
 {
-    for(s32 it = 0; it < world.w() * world.h(); ++it)
+    const Maps::Tiles & tile = world.GetTiles(index);
+    if(tile.isFog(color)) return false;
+
+    if(MP2::isGroundObject(tile.GetObject()) ||
+	MP2::isWaterObject(tile.GetObject()) || MP2::OBJ_HEROES == tile.GetObject())
     {
-        const Maps::Tiles & tile = world.GetTiles(it);
-        if(tile.isFog(color)) continue;
+        // if quantity object is empty
+        if(MP2::isQuantityObject(tile.GetObject()) &&
+	    ! MP2::isPickupObject(tile.GetObject()) && ! tile.QuantityIsValid()) return false;
+
+	// skip captured obj
+	if(MP2::isCaptureObject(tile.GetObject()) &&
+	    Players::isFriends(color, tile.QuantityColor())) return false;
 
-        if(MP2::isGroundObject(tile.GetObject()) ||
-	    MP2::isWaterObject(tile.GetObject()) || MP2::OBJ_HEROES == tile.GetObject())
+        // skip for meeting heroes
+        if(MP2::OBJ_HEROES == tile.GetObject())
         {
-            // if quantity object is empty
-            if(MP2::isQuantityObject(tile.GetObject()) &&
-		! MP2::isPickupObject(tile.GetObject()) && ! tile.QuantityIsValid()) continue;
-
-	    // skip captured obj
-	    if(MP2::isCaptureObject(tile.GetObject()) &&
-		Players::isFriends(color, tile.QuantityColor())) continue;
-
-            // skip for meeting heroes
-            if(MP2::OBJ_HEROES == tile.GetObject())
-            {
-                const Heroes* hero = tile.GetHeroes();
-                if(hero && color == hero->GetColor()) continue;
-            }
-
-            // check: is visited objects
-            switch(tile.GetObject())
-            {
-                case MP2::OBJ_MAGELLANMAPS:
-                case MP2::OBJ_OBSERVATIONTOWER:
-                    if(world.GetKingdom(color).isVisited(tile)) continue;
-                    break;
-
-                default: break;
-            }
-
-            store[it] = tile.GetObject();
+            const Heroes* hero = tile.GetHeroes();
+            if(hero && color == hero->GetColor()) return false;
         }
+
+        // check: is visited objects
+        switch(tile.GetObject())
+        {
+            case MP2::OBJ_MAGELLANMAPS:
+            case MP2::OBJ_OBSERVATIONTOWER:
+                if(world.GetKingdom(color).isVisited(tile)) return false;
+                break;
+
+            default: break;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+void WorldStoreObjects(u8 color, IndexObjectMap & store)
+{
+    // fog tiles are skipped: scan the revealed only
+    Maps::Indexes revealed;
+    revealed.reserve(world.GetFog().CountRevealed(color));
+    world.GetFog().GetRevealed(color, revealed);
+
+    for(Maps::Indexes::const_iterator
+	it = revealed.begin(); it != revealed.end(); ++it)
+	if(WorldStoreObject(color, *it)) store[*it] = world.GetTiles(*it).GetObject();
+}
+
+/* rescan only the tiles changed from the last turn */
+void WorldUpdateObjects(u8 color, AIKingdom & ai)
+{
+    for(std::set<s32>::const_iterator
+	it = ai.changes.begin(); it != ai.changes.end(); ++it)
+    {
+	if(WorldStoreObject(color, *it))
+	    ai.scans[*it] = world.GetTiles(*it).GetObject();
+	else
+	    ai.scans.erase(*it);
+    }
+
+    ai.changes.clear();
+}
+
+/* world changes after the planning */
+std::vector<s32> & AIWorldChanges(void)
+{
+    static std::vector<s32> changes;
+    return changes;
+}
+
+void AI::WorldObjectChanged(const s32 & index, u8 colors)
+{
+    AIWorldChanges().push_back(index);
+
+    for(u8 color = Color::BLUE; color <= Color::PURPLE; color <<= 1)
+	if(colors & color)
+    {
+	AIKingdom & ai = AIKingdoms::Get(Color::Get(color));
+	if(ai.scanned) ai.changes.insert(index);
+    }
+}
+
+void WorldScanObjects(u8 color, AIKingdom & ai)
+{
+    if(ai.scanned)
+    {
+	DEBUG(DBG_AI, DBG_INFO, Color::String(color) << ", changed tiles: " << ai.changes.size());
+	WorldUpdateObjects(color, ai);
+    }
+    else
+    {
+	ai.scans.clear();
+	ai.changes.clear();
+	WorldStoreObjects(color, ai.scans);
+	ai.scanned = true;
     }
 }
 
+struct AIKingdomPlan
+{
+    AIKingdomPlan() : kingdom(NULL), ai(NULL) {}
+
+    const Kingdom*	kingdom;
+    AIKingdom*		ai;
+    std::vector< std::pair<const Heroes*, AIHero*> > heroes;
+    SDL::Thread		thread;
+};
+
+/* read only for the world: writes the own kingdom and heroes plan only */
+int AIKingdomPlanning(void* param)
+{
+    AIKingdomPlan & plan = *static_cast<AIKingdomPlan*>(param);
+
+    WorldScanObjects(plan.kingdom->GetColor(), *plan.ai);
+
+    // distance fields and task candidates, the task is selected in the turn
+    for(std::vector< std::pair<const Heroes*, AIHero*> >::iterator
+	it = plan.heroes.begin(); it != plan.heroes.end(); ++it)
+    {
+	AIHeroesPlanField(*(*it).first, *(*it).second);
+	AIHeroesPlanTasks(*(*it).first, *(*it).second, *plan.ai);
+    }
+
+    return 0;
+}
+
+/* two phase AI turn: the plans of all AI kingdoms are prepared in parallel from
+   the world of the day start, the turns are applied in order and validate the plans */
+void AI::KingdomsPlan(bool threads)
+{
+    const Colors colors(Settings::Get().GetPlayers().GetColors(CONTROL_AI, true));
+    std::vector<AIKingdomPlan> plans(colors.size());
+
+    AIWorldChanges().clear();
+
+    for(u8 ii = 0; ii < colors.size(); ++ii)
+    {
+	const Kingdom & kingdom = world.GetKingdom(colors[ii]);
+	AIKingdomPlan & plan = plans[ii];
+
+	if(! kingdom.isPlay()) continue;
+
+	plan.kingdom = &kingdom;
+	plan.ai = &AIKingdoms::Get(colors[ii]);
+
+	const KingdomHeroes & heroes = kingdom.GetHeroes();
+	for(KingdomHeroes::const_iterator
+	    it = heroes.begin(); it != heroes.end(); ++it)
+	    plan.heroes.push_back(std::make_pair(*it, &AIHeroes::Get(**it)));
+    }
+
+    for(std::vector<AIKingdomPlan>::iterator
+	it = plans.begin(); it != plans.end(); ++it)
+	if((*it).kingdom && threads) (*it).thread.Create(AIKingdomPlanning, &(*it));
+
+    for(std::vector<AIKingdomPlan>::iterator
+	it = plans.begin(); it != plans.end(); ++it) if((*it).kingdom)
+    {
+	// threads not available
+	if((*it).thread.IsRun())
+	    (*it).thread.Wait();
+	else
+	    AIKingdomPlanning(&(*it));
+    }
+
+    DEBUG(DBG_AI, DBG_INFO, "kingdoms: " << colors.String());
+}
+
 void AI::KingdomTurn(Kingdom & kingdom)
 {
     KingdomHeroes & heroes = kingdom.GetHeroes();
@@ -145,11 +279,26 @@ void AI::KingdomTurn(Kingdom & kingdom)
     // turn indicator
     if(status) status->RedrawTurnProgress(0);
 
-    // scan map
-    ai.scans.clear();
-    WorldStoreObjects(color, ai.scans);
+    AI_PROFILE_KINGDOM(color);
+
+    // scan map: planned, validate the changes after the planning
+    {
+	AI_PROFILE(SCAN);
+	WorldScanObjects(color, ai);
+    }
     DEBUG(DBG_AI, DBG_INFO, Color::String(color) << ", size cache objects: " << ai.scans.size());
 
+#ifdef WITH_DEBUG
+    // cross-check with the full scan
+    if(IS_DEBUG(DBG_AI, DBG_TRACE))
+    {
+	IndexObjectMap full;
+	WorldStoreObjects(color, full);
+	if(full != ai.scans)
+	    DEBUG(DBG_AI, DBG_WARN, Color::String(color) << ", scan mismatch, full: " << full.size() << ", incremental: " << ai.scans.size());
+    }
+#endif
+
     // set capital
     if(NULL == ai.capital && castles.size())
     {
@@ -175,7 +324,10 @@ void AI::KingdomTurn(Kingdom & kingdom)
     if(status) status->RedrawTurnProgress(1);
 
     // castles AI turn
-    std::for_each(castles.begin(), castles.end(), AICastleTurn);
+    {
+	AI_PROFILE(CASTLES);
+	std::for_each(castles.begin(), castles.end(), AICastleTurn);
+    }
 
     // need capture town?
     if(castles.empty())
@@ -184,6 +336,7 @@ void AI::KingdomTurn(Kingdom & kingdom)
     // buy hero in capital
     if(ai.capital && ai.capital->isCastle())
     {
+	AI_PROFILE(RECRUIT);
 	u32 modes = 0;
 	const u8 maxhero = Maps::XLARGE > world.w() ? (Maps::LARGE > world.w() ? 3 : 2) : 4;
 
@@ -284,5 +437,7 @@ void AI::KingdomTurn(Kingdom & kingdom)
     // turn indicator
     if(status) status->RedrawTurnProgress(9);
 
+    AI_PROFILE_KINGDOM(Color::NONE);
+
     DEBUG(DBG_AI, DBG_INFO, Color::String(color) << " moved");
 }
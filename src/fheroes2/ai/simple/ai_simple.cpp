@@ -31,6 +31,7 @@
 #include "heroes.h"
 #include "castle.h"
 #include "ai_simple.h"
+#include "ai_profile.h"
 
 const char* AI::Type(void)
 {
@@ -69,6 +70,7 @@ void AI::Init(void)
 {
     AIKingdoms::Reset();
     AIHeroes::Reset();
+    AI_PROFILE_RESET();
 }
 
 bool Queue::isPresent(s32 index) const
@@ -31,10 +31,12 @@
 #define H2AI_SIMPLE_H
 
 #include <map>
+#include <set>
 #include <list>
 #include <vector>
 
 #include "pairs.h"
+#include "route.h"
 #include "ai.h"
 
 struct IndexObjectMap : public std::map<s32, MP2::object_t>
@@ -44,11 +46,13 @@ struct IndexObjectMap : public std::map<s32, MP2::object_t>
 
 struct AIKingdom
 {
-    AIKingdom() : capital(NULL) {};
+    AIKingdom() : capital(NULL), scanned(false) {};
     void Reset(void);
 
     Castle*         capital;
     IndexObjectMap  scans;
+    std::set<s32>   changes;	// tiles to rescan, see AI::WorldObjectChanged
+    bool            scanned;
 };
 
 class AIKingdoms : public std::vector<AIKingdom>
@@ -69,7 +73,8 @@ struct Queue : public std::list<s32>
 
 struct AIHero
 {
-    AIHero() : primary_target(-1), fix_loop(0) {};
+    AIHero() : primary_target(-1), fix_loop(0), field_serial(0), field_count(0),
+	tasks_reachable(0), tasks_field(MAXU32), tasks_serial(0) {};
 
     void ClearTasks(void) { sheduled_visit.clear(); }
     void Reset(void);
@@ -77,6 +82,17 @@ struct AIHero
     Queue           sheduled_visit;
     s32             primary_target;
     u8              fix_loop;
+
+    Route::DistanceField field;
+    u32             field_serial;	// position in AIWorldChanges
+    u32             field_count;	// field calculations
+
+    // task candidates, planned with the field: the reachable first, then the others
+    std::vector<IndexDistance> tasks;
+    std::vector<s32> tasks_tiles;	// sorted: the tiles of the candidates
+    u32             tasks_reachable;
+    u32             tasks_field;	// field_count of the plan
+    u32             tasks_serial;	// position in AIWorldChanges
 };
 
 struct AIHeroes : public std::vector<AIHero>
@@ -90,4 +106,8 @@ private:
     AIHeroes() : std::vector<AIHero>(HEROESMAXCOUNT + 2) {};
 };
 
+std::vector<s32> & AIWorldChanges(void);
+void AIHeroesPlanField(const Heroes &, AIHero &);
+void AIHeroesPlanTasks(const Heroes &, AIHero &, const AIKingdom &);
+
 #endif
@@ -827,8 +827,41 @@ s8 Army::GetMorale(void) const
     return commander ? commander->GetMorale() : GetMoraleModificator(NULL);
 }
 
-// TODO:: need optimize
+Army::DerivedStats::DerivedStats() : morale(0), valid(false)
+{
+    std::fill(key, key + ARRAY_COUNT(key), 0);
+}
+
+void Army::GetDerivedKey(u8* key) const
+{
+    for(u8 ii = 0; ii < ARMYMAXTROOPS; ++ii)
+    {
+	const Troop* troop = ii < size() ? at(ii) : NULL;
+	key[ii] = troop && troop->isValid() ? troop->GetID() : static_cast<u8>(Monster::UNKNOWN);
+    }
+
+    key[ARMYMAXTROOPS] = commander && commander->HasArtifact(Artifact::ARM_MARTYR) ? 1 : 0;
+}
+
 s8 Army::GetMoraleModificator(std::string *strs) const
+{
+    // description: full calculate
+    if(strs) return CalculateMoraleModificator(strs);
+
+    u8 key[ARRAY_COUNT(derived.key)];
+    GetDerivedKey(key);
+
+    if(! derived.valid || ! std::equal(key, key + ARRAY_COUNT(key), derived.key))
+    {
+	derived.morale = CalculateMoraleModificator(NULL);
+	std::copy(key, key + ARRAY_COUNT(key), derived.key);
+	derived.valid = true;
+    }
+
+    return derived.morale;
+}
+
+s8 Army::CalculateMoraleModificator(std::string *strs) const
 {
     s8 result(Morale::NORMAL);
 
@@ -1219,6 +1252,9 @@ StreamBase & operator>> (StreamBase & msg, Army & army)
     for(Army::iterator it = army.begin(); it != army.end(); ++it)
 	msg >> **it;
 
+    // derived stats: transient
+    army.derived.valid = false;
+
     msg >> army.combat_format >> army.color;
 
     u8 type; s32 index;
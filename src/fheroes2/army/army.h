@@ -159,6 +159,21 @@ protected:
 
 private:
     Army &		operator= (const Army &) { return *this; }
+
+    // morale by troops: recomputed after the troops changes, not saved
+    struct DerivedStats
+    {
+	DerivedStats();
+
+	u8		key[ARMYMAXTROOPS + 1]; // troops, arm martyr
+	s8		morale;
+	bool		valid;
+    };
+
+    s8			CalculateMoraleModificator(std::string *strs) const;
+    void		GetDerivedKey(u8*) const;
+
+    mutable DerivedStats derived;
 };
 
 StreamBase & operator<< (StreamBase &, const Army &);
@@ -836,13 +836,11 @@ void Battle::Arena::ApplyActionSpellEarthQuake(StreamBuf & stream)
     // FIXME: Arena::ApplyActionSpellEarthQuake: check hero spell power
 
     // apply random damage
-    if(0 != board[8].GetObject())  board[8].SetObject(Rand::Get(board[8].GetObject()));
-    if(0 != board[29].GetObject()) board[29].SetObject(Rand::Get(board[29].GetObject()));
-    if(0 != board[73].GetObject()) board[73].SetObject(Rand::Get(board[73].GetObject()));
-    if(0 != board[96].GetObject()) board[96].SetObject(Rand::Get(board[96].GetObject()));
+    for(u8 wall = CAT_WALL1; wall <= CAT_WALL4; ++wall)
+	if(0 != GetCastleTargetValue(wall)) SetCastleTargetValue(wall, Rand::Get(GetCastleTargetValue(wall)));
 
-    if(towers[0] && towers[0]->isValid() && Rand::Get(1)) towers[0]->SetDestroy();
-    if(towers[2] && towers[2]->isValid() && Rand::Get(1)) towers[2]->SetDestroy();
+    if(GetCastleTargetValue(CAT_TOWER1) && Rand::Get(1)) SetCastleTargetValue(CAT_TOWER1, 0);
+    if(GetCastleTargetValue(CAT_TOWER2) && Rand::Get(1)) SetCastleTargetValue(CAT_TOWER2, 0);
 
     DEBUG(DBG_BATTLE, DBG_TRACE, "spell: " << Spell(Spell::EARTHQUAKE).GetName() << ", targets: " << targets.size());
 }
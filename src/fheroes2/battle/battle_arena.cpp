@@ -169,6 +169,16 @@ Battle::Graveyard* Battle::Arena::GetGraveyard(void)
     return &arena->graveyard;
 }
 
+Battle::DamageCache* Battle::Arena::GetDamageCache(void)
+{
+    return arena ? &arena->damage_cache : NULL;
+}
+
+const Battle::SiegeState* Battle::Arena::GetSiege(void)
+{
+    return &arena->siege;
+}
+
 Battle::Interface* Battle::Arena::GetInterface(void)
 {
     return arena->interface;
@@ -238,6 +248,7 @@ Battle::Arena::Arena(Army & a1, Army & a2, s32 index, bool local) :
 	bool fortification = (Race::KNGT == castle->GetRace()) && castle->isBuild(BUILD_SPEC);
 	catapult = army1->GetCommander() ? new Catapult(*army1->GetCommander(), fortification) : NULL;
 	bridge = new Bridge();
+	siege.Init(fortification, NULL != towers[0], NULL != towers[2], castle->isBuild(BUILD_MOAT));
 
 	// catapult cell
 	board[77].SetObject(1);
@@ -397,6 +408,8 @@ void Battle::Arena::Turns(void)
     army1->NewTurn();
     army2->NewTurn();
 
+    damage_cache.Reset();
+
     bool tower_moved = false;
     bool catapult_moved = false;
 
@@ -767,6 +780,11 @@ Battle::Indexes Battle::Arena::GraveyardClosedCells(void) const
 
 void Battle::Arena::SetCastleTargetValue(u8 target, u8 value)
 {
+    // walls changed: obstacles penalty
+    damage_cache.Reset();
+
+    siege.SetValue(target, value);
+
     switch(target)
     {
         case CAT_WALL1: board[8].SetObject(value); break;
@@ -793,22 +811,7 @@ void Battle::Arena::SetCastleTargetValue(u8 target, u8 value)
 
 u8 Battle::Arena::GetCastleTargetValue(u8 target) const
 {
-    switch(target)
-    {
-        case CAT_WALL1: return board[8].GetObject();
-        case CAT_WALL2: return board[29].GetObject();
-        case CAT_WALL3: return board[73].GetObject();
-        case CAT_WALL4: return board[96].GetObject();
-
-        case CAT_TOWER1:return towers[0] && towers[0]->isValid();
-        case CAT_TOWER2:return towers[2] && towers[2]->isValid();
-        case CAT_TOWER3:return towers[1] && towers[1]->isValid();
-
-        case CAT_BRIDGE:return bridge->isValid();
-
-        default: break;
-    }
-    return 0;
+    return siege.GetValue(target);
 }
 
 std::vector<u8> Battle::Arena::GetCastleTargets(void) const
@@ -816,15 +819,9 @@ std::vector<u8> Battle::Arena::GetCastleTargets(void) const
     std::vector<u8> targets;
     targets.reserve(8);
 
-    // check walls
-    if(0 != board[8].GetObject())  targets.push_back(CAT_WALL1);
-    if(0 != board[29].GetObject()) targets.push_back(CAT_WALL2);
-    if(0 != board[73].GetObject()) targets.push_back(CAT_WALL3);
-    if(0 != board[96].GetObject()) targets.push_back(CAT_WALL4);
-
-    // check right/left towers
-    if(towers[0] && towers[0]->isValid()) targets.push_back(CAT_TOWER1);
-    if(towers[2] && towers[2]->isValid()) targets.push_back(CAT_TOWER2);
+    // walls and right/left towers
+    for(u8 target = CAT_WALL1; target <= CAT_TOWER2; ++target)
+	if(siege.GetTargets() & (1 << target)) targets.push_back(target);
 
     return targets;
 }
@@ -832,7 +829,7 @@ std::vector<u8> Battle::Arena::GetCastleTargets(void) const
 StreamBase & Battle::operator<< (StreamBase & msg, const Arena & a)
 {
     msg <<
-	a.current_turn << a.board <<
+	a.current_turn << a.board << a.siege <<
 	*a.army1 << *a.army2;
 
     const HeroBase* hero1 = a.army1->GetCommander();
@@ -853,7 +850,7 @@ StreamBase & Battle::operator<< (StreamBase & msg, const Arena & a)
 
 StreamBase & Battle::operator>> (StreamBase & msg, Arena & a)
 {
-    msg >> a.current_turn >> a.board >>
+    msg >> a.current_turn >> a.board >> a.siege >>
 	*a.army1 >> *a.army2;
 
     u8 type;
@@ -1001,19 +998,22 @@ u8 Battle::Arena::GetObstaclesPenalty(const Unit & attacker, const Unit & defend
 	if(defender.GetColor() == castle->GetColor() &&
 	    defender.OutOfWalls()) return 0;
 
-	// check castle walls defensed
-	const Points points = GetLinePoints(attacker.GetBackPoint(), defender.GetBackPoint(), step);
-
-	for(Points::const_iterator
-	    it = points.begin(); it != points.end(); ++it)
+	// check castle walls defensed: only the broken walls can open the line
+	if(siege.GetBrokenWalls())
 	{
-	    if(0 == board[8].GetObject() && (board[8].GetPos() & *it)) return 0;
-	    else
-	    if(0 == board[29].GetObject() && (board[29].GetPos() & *it)) return 0;
-	    else
-	    if(0 == board[73].GetObject() && (board[73].GetPos() & *it)) return 0;
-	    else
-	    if(0 == board[96].GetObject() && (board[96].GetPos() & *it)) return 0;
+	    const Points points = GetLinePoints(attacker.GetBackPoint(), defender.GetBackPoint(), step);
+
+	    for(Points::const_iterator
+		it = points.begin(); it != points.end(); ++it)
+	    {
+		if(siege.isWallBroken(CAT_WALL1) && (board[8].GetPos() & *it)) return 0;
+		else
+		if(siege.isWallBroken(CAT_WALL2) && (board[29].GetPos() & *it)) return 0;
+		else
+		if(siege.isWallBroken(CAT_WALL3) && (board[73].GetPos() & *it)) return 0;
+		else
+		if(siege.isWallBroken(CAT_WALL4) && (board[96].GetPos() & *it)) return 0;
+	    }
 	}
 
 	result = 1;
@@ -30,6 +30,8 @@
 #include "spell_storage.h"
 #include "battle_board.h"
 #include "battle_grave.h"
+#include "battle_damage.h"
+#include "battle_siege.h"
 
 #define ARENAW 11
 #define ARENAH 9
@@ -133,6 +135,8 @@ namespace Battle
 	static const Castle*	GetCastle(void);
 	static Interface*	GetInterface(void);
 	static Graveyard*	GetGraveyard(void);
+	static DamageCache*	GetDamageCache(void);
+	static const SiegeState* GetSiege(void);
 
     private:
 	friend StreamBase & operator<< (StreamBase &, const Arena &);
@@ -183,6 +187,8 @@ namespace Battle
 	Result		result_game;
 
 	Graveyard	graveyard;
+	DamageCache	damage_cache;
+	SiegeState	siege;
 	SpellStorage	usage_spells;
 
 	Board		board;
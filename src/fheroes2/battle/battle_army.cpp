@@ -29,9 +29,32 @@
 #include "battle_army.h"
 
 #define CAPACITY 16
+#define POOLSIZE 16
 
 namespace Battle
 {
+    // released Units buffers, reused by the next temporary Units
+    std::vector<Unit*> units_pool[POOLSIZE];
+    u8 units_pool_size = 0;
+    bool units_pool_enabled = true;
+
+    void UnitsAcquire(std::vector<Unit*> & units)
+    {
+	if(units_pool_enabled && units_pool_size)
+	    units.swap(units_pool[--units_pool_size]);
+	else
+	    units.reserve(CAPACITY);
+    }
+
+    void UnitsRelease(std::vector<Unit*> & units)
+    {
+	if(units_pool_enabled && units_pool_size < POOLSIZE && CAPACITY <= units.capacity())
+	{
+	    units.clear();
+	    units.swap(units_pool[units_pool_size++]);
+	}
+    }
+
     bool AllowPart1(const Unit* b)
     {
         return ! b->Modes(TR_SKIPMOVE) && Speed::STANDING < b->GetSpeed();
@@ -45,28 +68,29 @@ namespace Battle
 
 Battle::Units::Units()
 {
-    reserve(CAPACITY);
+    UnitsAcquire(*this);
 }
 
 Battle::Units::Units(const Units & units, bool filter)
 {
-    reserve(CAPACITY < units.size() ? units.size() : CAPACITY);
+    UnitsAcquire(*this);
+    reserve(units.size());
     assign(units.begin(), units.end());
-    if(filter)
-	resize(std::distance(begin(),
-	    std::remove_if(begin(), end(), std::not1(std::mem_fun(&Unit::isValid)))));
+    if(filter) Filter();
 }
 
 Battle::Units::Units(const Units & units1, const Units & units2)
 {
     const size_t capacity = units1.size() + units2.size();
-    reserve(CAPACITY < capacity ? capacity : CAPACITY);
+    UnitsAcquire(*this);
+    reserve(capacity);
     insert(end(), units1.begin(), units1.end());
     insert(end(), units2.begin(), units2.end());
 }
 
 Battle::Units::~Units()
 {
+    UnitsRelease(*this);
 }
 
 Battle::Units & Battle::Units::operator= (const Units & units)
@@ -77,6 +101,25 @@ Battle::Units & Battle::Units::operator= (const Units & units)
     return *this;
 }
 
+/* the tests: without the pool as the baseline */
+void Battle::Units::SetPoolEnabled(bool f)
+{
+    units_pool_enabled = f;
+}
+
+void Battle::Units::Assign(const Units & units1, const Units & units2)
+{
+    clear();
+    insert(end(), units1.begin(), units1.end());
+    insert(end(), units2.begin(), units2.end());
+}
+
+void Battle::Units::Filter(void)
+{
+    resize(std::distance(begin(),
+	std::remove_if(begin(), end(), std::not1(std::mem_fun(&Unit::isValid)))));
+}
+
 void Battle::Units::SortSlowest(void)
 {
     std::sort(begin(), end(), Army::SlowestTroop);
@@ -159,6 +202,14 @@ u8 Battle::Force::GetControl(void) const
     return army.GetControl();
 }
 
+const Battle::Units & Battle::Force::GetValidUnits(void) const
+{
+    valid.assign(begin(), end());
+    valid.Filter();
+
+    return valid;
+}
+
 bool Battle::Force::isValid(void) const
 {
     return end() != std::find_if(begin(), end(), std::mem_fun(&Unit::isValid));
@@ -218,7 +269,7 @@ Battle::Unit* Battle::Force::GetCurrentUnit(const Force & army1, const Force & a
     Units units2(army2, true);
 
     if(all)
-	*all = Units(army1, army2);
+	all->Assign(army1, army2);
 
     if(part1 || Settings::Get().ExtBattleReverseWaitOrder())
     {
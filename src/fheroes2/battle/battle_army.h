@@ -40,6 +40,9 @@ namespace Battle
 
 	Units &		operator= (const Units &);
 
+	void		Assign(const Units &, const Units &);
+	void		Filter(void);
+
 	Unit*		FindMode(u32);
         Unit*		FindUID(u32);
 
@@ -47,6 +50,8 @@ namespace Battle
         void		SortFastest(void);
         void		SortStrongest(void);
         void		SortWeakest(void);
+
+	static void	SetPoolEnabled(bool);
     };
 
     enum { ARMY_GUARDIANS_OBJECT = 0x10000 };
@@ -60,6 +65,8 @@ namespace Battle
     HeroBase*		GetCommander(void);
     const HeroBase*	GetCommander(void) const;
 
+    const Units &	GetValidUnits(void) const;
+
     bool		isValid(void) const;
     bool		HasMonster(const Monster &) const;
     u32			GetDeadHitPoints(void) const;
@@ -78,6 +85,7 @@ namespace Battle
 
     private:
 	Army &		army;
+	mutable Units	valid;
     };
 
     StreamBase & operator<< (StreamBase &, const Force &);
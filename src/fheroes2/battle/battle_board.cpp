@@ -80,7 +80,7 @@ void Battle::Board::Reset(void)
 void Battle::Board::SetPositionQuality(const Unit & b)
 {
     Arena* arena = GetArena();
-    Units enemies(arena->GetForce(b.GetColor(), true), true);
+    const Units & enemies = arena->GetForce(b.GetColor(), true).GetValidUnits();
 
     for(Units::const_iterator
 	it1 = enemies.begin(); it1 != enemies.end(); ++it1)
@@ -106,7 +106,7 @@ void Battle::Board::SetPositionQuality(const Unit & b)
 void Battle::Board::SetEnemyQuality(const Unit & b)
 {
     Arena* arena = GetArena();
-    Units enemies(arena->GetForce(b.GetColor(), true), true);
+    const Units & enemies = arena->GetForce(b.GetColor(), true).GetValidUnits();
 
     for(Units::const_iterator
         it = enemies.begin(); it != enemies.end(); ++it)
@@ -178,6 +178,8 @@ Battle::Indexes Battle::Board::GetAStarPath(const Unit & b, const Position & dst
 {
     const Castle* castle = Arena::GetCastle();
     const Bridge* bridge = Arena::GetBridge();
+    const bool moat = castle && Arena::GetSiege()->isMoat();
+    const bool bridge_passable = !bridge || bridge->isPassable(b.GetColor());
     std::map<s16, bcell_t> list;
     s16 cur = b.GetHeadIndex();
 
@@ -200,11 +202,11 @@ Battle::Indexes Battle::Board::GetAStarPath(const Unit & b, const Position & dst
 
 	    if(list[*it].open && cell.isPassable4(b, center) &&
 		// check bridge
-	        (!bridge || !Board::isBridgeIndex(*it) || bridge->isPassable(b.GetColor())))
+	        (bridge_passable || !Board::isBridgeIndex(*it)))
 	    {
 		const s16 cost = 100 * Board::GetDistance(*it, dst.GetHead()->GetIndex()) +
 		    (b.isWide() && WideDifficultDirection(center.GetDirection(), GetDirection(*it, cur)) ? 100 : 0) +
-		    (castle && castle->isBuild(BUILD_MOAT) && Board::isMoatIndex(*it) ? 100 : 0);
+		    (moat && Board::isMoatIndex(*it) ? 100 : 0);
 
 		// new cell
 		if(0 > list[*it].prnt)
@@ -280,7 +282,7 @@ Battle::Indexes Battle::Board::GetAStarPath(const Unit & b, const Position & dst
 	    result.resize(b.GetSpeed());
 
 	// skip moat position
-	if(castle && castle->isBuild(BUILD_MOAT) && ! Board::isMoatIndex(b.GetHeadIndex()))
+	if(moat && ! Board::isMoatIndex(b.GetHeadIndex()))
 	{
 	    Indexes::iterator moat = std::find_if(result.begin(), result.end(), Board::isMoatIndex);
 	    if(moat != result.end())
@@ -105,34 +105,34 @@ Point Battle::Catapult::GetTargetPosition(u8 target)
     return res;
 }
 
-u8 Battle::Catapult::GetTarget(const std::vector<u8> & values) const
+u8 Battle::Catapult::GetTarget(const SiegeState & state) const
 {
     std::vector<u8> targets;
     targets.reserve(4);
 
     // check walls
-    if(0 != values[CAT_WALL1]) targets.push_back(CAT_WALL1);
-    if(0 != values[CAT_WALL2]) targets.push_back(CAT_WALL2);
-    if(0 != values[CAT_WALL3]) targets.push_back(CAT_WALL3);
-    if(0 != values[CAT_WALL4]) targets.push_back(CAT_WALL4);
+    if(0 != state.GetValue(CAT_WALL1)) targets.push_back(CAT_WALL1);
+    if(0 != state.GetValue(CAT_WALL2)) targets.push_back(CAT_WALL2);
+    if(0 != state.GetValue(CAT_WALL3)) targets.push_back(CAT_WALL3);
+    if(0 != state.GetValue(CAT_WALL4)) targets.push_back(CAT_WALL4);
 
     // check right/left towers
     if(targets.empty())
     {
-	if(values[CAT_TOWER1]) targets.push_back(CAT_TOWER1);
-	if(values[CAT_TOWER2]) targets.push_back(CAT_TOWER2);
+	if(state.GetValue(CAT_TOWER1)) targets.push_back(CAT_TOWER1);
+	if(state.GetValue(CAT_TOWER2)) targets.push_back(CAT_TOWER2);
     }
 
     // check bridge
     if(targets.empty())
     {
-	if(values[CAT_BRIDGE]) targets.push_back(CAT_BRIDGE);
+	if(state.GetValue(CAT_BRIDGE)) targets.push_back(CAT_BRIDGE);
     }
 
     // check general tower
     if(targets.empty())
     {
-	if(values[CAT_TOWER3]) targets.push_back(CAT_TOWER3);
+	if(state.GetValue(CAT_TOWER3)) targets.push_back(CAT_TOWER3);
     }
 
     if(targets.size())
@@ -149,26 +149,17 @@ u8 Battle::Catapult::GetTarget(const std::vector<u8> & values) const
 Battle::Command Battle::Catapult::GetAction(Arena & arena) const
 {
     u8 shots = cat_shots;
-    std::vector<u8> values(CAT_MISS + 1, 0);
-
-    values[CAT_WALL1] = arena.GetCastleTargetValue(CAT_WALL1);
-    values[CAT_WALL2] = arena.GetCastleTargetValue(CAT_WALL2);
-    values[CAT_WALL3] = arena.GetCastleTargetValue(CAT_WALL3);
-    values[CAT_WALL4] = arena.GetCastleTargetValue(CAT_WALL4);
-    values[CAT_TOWER1] = arena.GetCastleTargetValue(CAT_TOWER1);
-    values[CAT_TOWER2] = arena.GetCastleTargetValue(CAT_TOWER2);
-    values[CAT_TOWER3] = arena.GetCastleTargetValue(CAT_TOWER3);
-    values[CAT_BRIDGE] = arena.GetCastleTargetValue(CAT_BRIDGE);
+    SiegeState state = *arena.GetSiege();
 
     Command cmd(MSG_BATTLE_CATAPULT);
     cmd.GetStream() << shots;
 
     while(shots--)
     {
-        const u8 & target = GetTarget(values);
-        const u8 & damage = GetDamage(target, arena.GetCastleTargetValue(target));
+        const u8 target = GetTarget(state);
+        const u8 damage = GetDamage(target, state.GetValue(target));
         cmd.GetStream() << target << damage;
-        values[target] -= damage;
+        state.SetValue(target, state.GetValue(target) - damage);
     }
 
     return cmd;
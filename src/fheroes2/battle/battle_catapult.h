@@ -41,7 +41,7 @@ namespace Battle
 	Command		GetAction(Arena &) const;
 
     private:
-	u8		GetTarget(const std::vector<u8> &) const;
+	u8		GetTarget(const SiegeState &) const;
 	u8		GetDamage(u8, u8) const;
 
 	u8	cat_shots;
@@ -0,0 +1,99 @@
+/***************************************************************************
+ *   Copyright (C) 2012 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "battle_troop.h"
+#include "battle_damage.h"
+
+bool Battle::DamageInfo::operator== (const DamageInfo & di) const
+{
+    return min == di.min && max == di.max && expected == di.expected && killed == di.killed;
+}
+
+Battle::DamageCache::DamageCache() : hits(0), misses(0)
+{
+}
+
+void Battle::DamageCache::Reset(void)
+{
+    items.clear();
+}
+
+u32 Battle::DamageCache::GetHits(void) const
+{
+    return hits;
+}
+
+u32 Battle::DamageCache::GetMisses(void) const
+{
+    return misses;
+}
+
+Battle::DamageInfo Battle::DamageCache::Calculate(const Unit & attacker, const Unit & defender)
+{
+    DamageInfo res;
+
+    res.min = attacker.CalculateDamageUnit(defender, attacker.ArmyTroop::GetDamageMin());
+    res.max = attacker.CalculateDamageUnit(defender, attacker.ArmyTroop::GetDamageMax());
+
+    if(attacker.Modes(SP_BLESS))
+	res.expected = res.max;
+    else
+    if(attacker.Modes(SP_CURSE))
+	res.expected = res.min;
+    else
+	res.expected = (res.min + res.max) / 2;
+
+    if(attacker.Modes(LUCK_GOOD)) res.expected <<= 1;
+    else
+    if(attacker.Modes(LUCK_BAD)) res.expected >>= 1;
+
+    res.killed = defender.HowManyWillKilled((res.min + res.max) / 2);
+
+    return res;
+}
+
+const Battle::DamageInfo & Battle::DamageCache::Get(const Unit & attacker, const Unit & defender)
+{
+    // modes and counts are checked also: the spell, morale and luck flags are often changed in place
+    const u32 modes1 = static_cast<const BitModes &>(attacker)();
+    const u32 modes2 = static_cast<const BitModes &>(defender)();
+
+    Item & item = items[std::make_pair(attacker.GetUID(), defender.GetUID())];
+
+    if(item.info.max &&
+	item.modes1 == modes1 && item.modes2 == modes2 &&
+	item.count1 == attacker.GetCount() && item.count2 == defender.GetCount())
+    {
+	++hits;
+    }
+    else
+    {
+	item.info = Calculate(attacker, defender);
+	item.modes1 = modes1;
+	item.modes2 = modes2;
+	item.count1 = attacker.GetCount();
+	item.count2 = defender.GetCount();
+	++misses;
+    }
+
+    return item.info;
+}
@@ -0,0 +1,77 @@
+/***************************************************************************
+ *   Copyright (C) 2012 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef H2BATTLE_DAMAGE_H
+#define H2BATTLE_DAMAGE_H
+
+#include <map>
+#include <utility>
+
+#include "gamedefs.h"
+
+namespace Battle
+{
+    class Unit;
+
+    struct DamageInfo
+    {
+	u32	min;
+	u32	max;
+	u32	expected;
+	u32	killed;
+
+	DamageInfo() : min(0), max(0), expected(0), killed(0) {}
+
+	bool	operator== (const DamageInfo &) const;
+    };
+
+    // attacker x defender damage table, reset every round
+    class DamageCache
+    {
+    public:
+	DamageCache();
+
+	const DamageInfo &	Get(const Unit &, const Unit &);
+	void			Reset(void);
+
+	u32			GetHits(void) const;
+	u32			GetMisses(void) const;
+
+	static DamageInfo	Calculate(const Unit &, const Unit &);
+
+    private:
+	struct Item
+	{
+	    DamageInfo	info;
+	    u32		modes1;
+	    u32		modes2;
+	    u32		count1;
+	    u32		count2;
+	};
+
+	std::map<std::pair<u32, u32>, Item> items;
+	u32		hits;
+	u32		misses;
+    };
+}
+
+#endif
@@ -33,6 +33,7 @@
 #include "kingdom.h"
 #include "game.h"
 #include "ai.h"
+#include "ai_profile.h"
 #include "battle_arena.h"
 #include "battle_army.h"
 
@@ -45,6 +46,7 @@ namespace Battle
 
 Battle::Result Battle::Loader(Army & army1, Army & army2, s32 mapsindex)
 {
+    AI_PROFILE(BATTLE);
     const Settings & conf = Settings::Get();
 
     // pre battle army1
@@ -69,7 +71,9 @@ Battle::Result Battle::Loader(Army & army1, Army & army2, s32 mapsindex)
         AGG::ICNRegistryEnable(true);
 
     AGG::ResetMixer();
-    bool local = (CONTROL_HUMAN & army1.GetControl()) || (CONTROL_HUMAN & army2.GetControl()) || IS_DEBUG(DBG_BATTLE, DBG_TRACE);
+    // without video (headless simulation) always remote
+    bool local = SDL::SubSystem(INIT_VIDEO) &&
+	((CONTROL_HUMAN & army1.GetControl()) || (CONTROL_HUMAN & army2.GetControl()) || IS_DEBUG(DBG_BATTLE, DBG_TRACE));
 
     Arena arena(army1, army2, mapsindex, local);
 
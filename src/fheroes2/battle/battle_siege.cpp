@@ -0,0 +1,124 @@
+/***************************************************************************
+ *   Copyright (C) 2012 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "battle_catapult.h"
+#include "battle_siege.h"
+
+#define WALL_BITS(wall) (2 * ((wall) - CAT_WALL1))
+
+Battle::SiegeState::SiegeState() : walls(0), targets(0), moat(false)
+{
+}
+
+void Battle::SiegeState::Init(bool fortification, bool tower1, bool tower2, bool moat2)
+{
+    walls = 0;
+    targets = 0;
+    moat = moat2;
+
+    for(u8 wall = CAT_WALL1; wall <= CAT_WALL4; ++wall)
+	SetValue(wall, fortification ? 3 : 2);
+
+    if(tower1) targets |= 1 << CAT_TOWER1;
+    if(tower2) targets |= 1 << CAT_TOWER2;
+
+    targets |= (1 << CAT_TOWER3) | (1 << CAT_BRIDGE);
+}
+
+u8 Battle::SiegeState::GetValue(u8 target) const
+{
+    switch(target)
+    {
+	case CAT_WALL1:
+	case CAT_WALL2:
+	case CAT_WALL3:
+	case CAT_WALL4:	return 0x03 & (walls >> WALL_BITS(target));
+
+	case CAT_TOWER1:
+	case CAT_TOWER2:
+	case CAT_TOWER3:
+	case CAT_BRIDGE: return (targets & (1 << target)) ? 1 : 0;
+
+	default: break;
+    }
+
+    return 0;
+}
+
+void Battle::SiegeState::SetValue(u8 target, u8 value)
+{
+    switch(target)
+    {
+	case CAT_WALL1:
+	case CAT_WALL2:
+	case CAT_WALL3:
+	case CAT_WALL4:
+	    if(3 < value) value = 0;
+	    walls &= ~(0x03 << WALL_BITS(target));
+	    walls |= value << WALL_BITS(target);
+	    break;
+
+	case CAT_TOWER1:
+	case CAT_TOWER2:
+	case CAT_TOWER3:
+	case CAT_BRIDGE:
+	    break;
+
+	default: return;
+    }
+
+    if(value)
+	targets |= 1 << target;
+    else
+	targets &= ~(1 << target);
+}
+
+u16 Battle::SiegeState::GetTargets(void) const
+{
+    return targets;
+}
+
+u8 Battle::SiegeState::GetBrokenWalls(void) const
+{
+    // bits CAT_WALL1 - CAT_WALL4
+    return ~targets & ((1 << CAT_WALL1) | (1 << CAT_WALL2) | (1 << CAT_WALL3) | (1 << CAT_WALL4));
+}
+
+bool Battle::SiegeState::isWallBroken(u8 wall) const
+{
+    return GetBrokenWalls() & (1 << wall);
+}
+
+bool Battle::SiegeState::isMoat(void) const
+{
+    return moat;
+}
+
+StreamBase & Battle::operator<< (StreamBase & msg, const SiegeState & state)
+{
+    return msg << state.walls << state.targets << state.moat;
+}
+
+StreamBase & Battle::operator>> (StreamBase & msg, SiegeState & state)
+{
+    return msg >> state.walls >> state.targets >> state.moat;
+}
@@ -0,0 +1,59 @@
+/***************************************************************************
+ *   Copyright (C) 2012 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef H2BATTLE_SIEGE_H
+#define H2BATTLE_SIEGE_H
+
+#include "gamedefs.h"
+
+namespace Battle
+{
+    // castle walls (2 bits per wall), towers and bridge: catapult targets bitset
+    class SiegeState
+    {
+    public:
+	SiegeState();
+
+	void	Init(bool fortification, bool tower1, bool tower2, bool moat);
+
+	u8	GetValue(u8) const;
+	void	SetValue(u8, u8);
+
+	u16	GetTargets(void) const;
+	u8	GetBrokenWalls(void) const;
+	bool	isWallBroken(u8) const;
+	bool	isMoat(void) const;
+
+    private:
+	friend StreamBase & operator<< (StreamBase &, const SiegeState &);
+	friend StreamBase & operator>> (StreamBase &, SiegeState &);
+
+	u8	walls;
+	u16	targets;
+	bool	moat;
+    };
+
+    StreamBase & operator<< (StreamBase &, const SiegeState &);
+    StreamBase & operator>> (StreamBase &, SiegeState &);
+}
+
+#endif
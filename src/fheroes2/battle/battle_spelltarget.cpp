@@ -0,0 +1,225 @@
+/***************************************************************************
+ *   Copyright (C) 2012 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include "settings.h"
+#include "heroes_base.h"
+#include "battle_arena.h"
+#include "battle_cell.h"
+#include "battle_troop.h"
+#include "battle_spelltarget.h"
+
+namespace Battle
+{
+    typedef std::vector< std::pair<s8, s8> > SpellMask;
+
+    // area masks: [radius][odd row], offsets from the cast cell
+    SpellMask spell_masks[3][2];
+
+    const SpellMask & GetSpellMask(u8 radius, bool odd)
+    {
+	SpellMask & mask = spell_masks[radius][odd ? 1 : 0];
+
+	if(mask.empty())
+	{
+	    const s16 center = (odd ? 3 : 4) * ARENAW + ARENAW / 2;
+	    const Indexes indexes = Board::GetDistanceIndexes(center, radius);
+
+	    mask.reserve(indexes.size() + 1);
+	    mask.push_back(std::make_pair(0, 0));
+
+	    for(Indexes::const_iterator
+		it = indexes.begin(); it != indexes.end(); ++it)
+		mask.push_back(std::make_pair(*it % ARENAW - center % ARENAW, *it / ARENAW - center / ARENAW));
+	}
+
+	return mask;
+    }
+}
+
+Battle::SpellEvaluator::SpellEvaluator(const HeroBase & h) : hero(h), stamp(0)
+{
+    std::fill(units, units + ARENASIZE, static_cast<const Unit*>(NULL));
+    std::fill(values, values + ARENASIZE, 0);
+    std::fill(marks, marks + ARENASIZE, 0);
+}
+
+u8 Battle::SpellEvaluator::GetRadius(const Spell & spell)
+{
+    switch(spell())
+    {
+	case Spell::FIREBALL:
+	case Spell::METEORSHOWER:
+	case Spell::COLDRING:	return 1;
+	case Spell::FIREBLAST:	return 2;
+
+	default: break;
+    }
+
+    return 0;
+}
+
+bool Battle::SpellEvaluator::isMassDamage(const Spell & spell)
+{
+    switch(spell())
+    {
+	case Spell::DEATHRIPPLE:
+	case Spell::DEATHWAVE:
+	case Spell::HOLYWORD:
+	case Spell::HOLYSHOUT:
+	case Spell::ELEMENTALSTORM:
+	case Spell::ARMAGEDDON:	return true;
+
+	default: break;
+    }
+
+    return false;
+}
+
+s32 Battle::SpellEvaluator::GetUnitValue(const Unit & unit, const Spell & spell) const
+{
+    if(! unit.isValid() || ! unit.AllowApplySpell(spell, &hero)) return 0;
+
+    const u32 dmg = unit.CalculateSpellDamage(spell, hero.GetPower(), &hero);
+    const u32 hp = unit.GetHitPoints();
+
+    if(0 == dmg || 0 == hp) return 0;
+
+    // strength part of the stack destroyed
+    float res = static_cast<float>(unit.GetStrength()) * (dmg < hp ? dmg : hp) / hp;
+
+    const u8 resist = unit.GetMagicResist(spell, hero.GetPower());
+    if(resist) res = res * (100 - resist) / 100;
+
+    return static_cast<s32>(unit.GetColor() == hero.GetColor() ? -res : res);
+}
+
+void Battle::SpellEvaluator::SetUnitValues(const Spell & spell)
+{
+    const Board & board = *Arena::GetBoard();
+
+    for(Board::const_iterator
+	it = board.begin(); it != board.end(); ++it)
+    {
+	const s16 & index = (*it).GetIndex();
+	const Unit* unit = (*it).GetUnit();
+
+	if(unit && unit->GetHeadIndex() != index)
+	{
+	    // tail cell: the value is stored once, on the head
+	    units[index] = unit;
+	    values[index] = 0;
+	}
+	else
+	{
+	    units[index] = unit;
+	    values[index] = unit ? GetUnitValue(*unit, spell) : 0;
+	}
+    }
+}
+
+Battle::SpellTarget Battle::SpellEvaluator::Evaluate(const Spell & spell)
+{
+    SpellTarget res;
+    res.spell = spell;
+
+    if(! spell.isDamage() || ! hero.CanCastSpell(spell)) return res;
+
+    SetUnitValues(spell);
+
+    if(isMassDamage(spell))
+    {
+	// all troops on board
+	for(s16 index = 0; index < ARENASIZE; ++index)
+	    res.value += values[index];
+
+	return res;
+    }
+
+    const u8 radius = GetRadius(spell);
+    const bool skip_center = spell == Spell::COLDRING;
+
+    for(s16 dst = 0; dst < ARENASIZE; ++dst)
+    {
+	s32 value = 0;
+
+	if(0 == radius)
+	{
+	    // single target (chain lightning: first strike)
+	    if(units[dst]) value = values[units[dst]->GetHeadIndex()];
+	}
+	else
+	{
+	    const SpellMask & mask = GetSpellMask(radius, (dst / ARENAW) % 2);
+	    const s8 cx = dst % ARENAW;
+	    const s8 cy = dst / ARENAW;
+
+	    ++stamp;
+
+	    for(SpellMask::const_iterator
+		it = mask.begin(); it != mask.end(); ++it)
+	    {
+		const s8 x = cx + (*it).first;
+		const s8 y = cy + (*it).second;
+
+		if(x < 0 || x >= ARENAW || y < 0 || y >= ARENAH) continue;
+		if(skip_center && x == cx && y == cy) continue;
+
+		const Unit* unit = units[y * ARENAW + x];
+
+		// wide troops are counted once
+		if(unit && marks[unit->GetHeadIndex()] != stamp)
+		{
+		    marks[unit->GetHeadIndex()] = stamp;
+		    value += values[unit->GetHeadIndex()];
+		}
+	    }
+	}
+
+	if(value > res.value)
+	{
+	    res.dst = dst;
+	    res.value = value;
+	}
+    }
+
+    return res;
+}
+
+Battle::SpellTarget Battle::SpellEvaluator::GetBest(const u8* spells, u8 count)
+{
+    SpellTarget res;
+
+    for(u8 ii = 0; ii < count; ++ii)
+    {
+	const SpellTarget target = Evaluate(Spell(spells[ii]));
+
+	if(target.value > res.value)
+	    res = target;
+    }
+
+    DEBUG(DBG_BATTLE, DBG_TRACE, res.spell.GetName() << ", dst: " << res.dst << ", value: " << res.value);
+
+    return res;
+}
@@ -0,0 +1,69 @@
+/***************************************************************************
+ *   Copyright (C) 2012 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef H2BATTLE_SPELLTARGET_H
+#define H2BATTLE_SPELLTARGET_H
+
+#include "gamedefs.h"
+#include "spell.h"
+#include "battle_board.h"
+
+class HeroBase;
+
+namespace Battle
+{
+    class Unit;
+
+    struct SpellTarget
+    {
+	Spell	spell;
+	s16	dst;
+	s32	value;
+
+	SpellTarget() : dst(-1), value(0) {}
+    };
+
+    // damage spells: score all cast destinations with the area masks
+    class SpellEvaluator
+    {
+    public:
+	SpellEvaluator(const HeroBase &);
+
+	SpellTarget	Evaluate(const Spell &);
+	SpellTarget	GetBest(const u8*, u8);
+
+	static u8	GetRadius(const Spell &);
+	static bool	isMassDamage(const Spell &);
+
+    private:
+	void		SetUnitValues(const Spell &);
+	s32		GetUnitValue(const Unit &, const Spell &) const;
+
+	const HeroBase & hero;
+	const Unit*	units[ARENASIZE];
+	s32		values[ARENASIZE];
+	u32		marks[ARENASIZE];
+	u32		stamp;
+    };
+}
+
+#endif
@@ -133,6 +133,13 @@ namespace Battle
     };
 
     u8 genie_enemy_half_percent = 10;
+
+    /* the damage table of the current battle, if any */
+    void ResetDamageCache(void)
+    {
+	DamageCache* cache = Arena::GetDamageCache();
+	if(cache) cache->Reset();
+    }
 }
 
 void Battle::UpdateMonsterAttributes(const std::string & spec)
@@ -339,6 +346,9 @@ void Battle::Unit::SetPosition(s16 pos)
 
     if(position.GetHead()) position.GetHead()->SetUnit(this);
     if(position.GetTail()) position.GetTail()->SetUnit(this);
+
+    // hand fighting and obstacles penalty changed
+    ResetDamageCache();
 }
 
 void Battle::Unit::SetPosition(const Position & pos)
@@ -351,6 +361,8 @@ void Battle::Unit::SetPosition(const Position & pos)
     if(position.GetHead()) position.GetHead()->SetUnit(this);
     if(position.GetTail()) position.GetTail()->SetUnit(this);
 
+    ResetDamageCache();
+
     if(isWide())
     {
 	reflect = GetHeadIndex() < GetTailIndex();
@@ -510,6 +522,8 @@ s16 Battle::Unit::GetTailIndex(void) const
 
 void Battle::Unit::SetRandomMorale(void)
 {
+    ResetDamageCache();
+
     switch(GetMorale())
     {
         case Morale::TREASON:   if(9 > Rand::Get(1, 16)) SetModes(MORALE_BAD); break;     // 50%
@@ -524,6 +538,8 @@ void Battle::Unit::SetRandomMorale(void)
 
 void Battle::Unit::SetRandomLuck(void)
 {
+    ResetDamageCache();
+
     s8 f = GetLuck();
 
     //check enemy: have bone dragon
@@ -661,14 +677,20 @@ u8 Battle::Unit::GetSpeed(bool skip_standing_check) const
     return speed;
 }
 
+Battle::DamageInfo Battle::Unit::GetDamageInfo(const Unit & enemy) const
+{
+    DamageCache* cache = Arena::GetDamageCache();
+    return cache ? cache->Get(*this, enemy) : DamageCache::Calculate(*this, enemy);
+}
+
 u32 Battle::Unit::GetDamageMin(const Unit & enemy) const
 {
-    return CalculateDamageUnit(enemy, ArmyTroop::GetDamageMin());
+    return GetDamageInfo(enemy).min;
 }
 
 u32 Battle::Unit::GetDamageMax(const Unit & enemy) const
 {
-    return CalculateDamageUnit(enemy, ArmyTroop::GetDamageMax());
+    return GetDamageInfo(enemy).max;
 }
 
 u32 Battle::Unit::CalculateDamageUnit(const Unit & enemy, float dmg) const
@@ -730,15 +752,16 @@ u32 Battle::Unit::CalculateDamageUnit(const Unit & enemy, float dmg) const
 
 u32 Battle::Unit::GetDamage(const Unit & enemy) const
 {
+    const DamageInfo info = GetDamageInfo(enemy);
     u32 res = 0;
 
     if(Modes(SP_BLESS))
-	res = GetDamageMax(enemy);
+	res = info.max;
     else
     if(Modes(SP_CURSE))
-    	res = GetDamageMin(enemy);
+    	res = info.min;
     else
-	res = Rand::Get(GetDamageMin(enemy), GetDamageMax(enemy));
+	res = Rand::Get(info.min, info.max);
 
     if(Modes(LUCK_GOOD)) res <<= 1; // mul 2
     else
@@ -749,7 +772,7 @@ u32 Battle::Unit::GetDamage(const Unit & enemy) const
 
 u32 Battle::Unit::HowManyCanKill(const Unit & b) const
 {
-    return b.HowManyWillKilled((GetDamageMin(b) + GetDamageMax(b)) / 2);
+    return GetDamageInfo(b).killed;
 }
 
 u32 Battle::Unit::HowManyWillKilled(u32 dmg) const
@@ -775,6 +798,8 @@ u32 Battle::Unit::ApplyDamage(u32 dmg)
 
 	DEBUG(DBG_BATTLE, DBG_TRACE, dmg << " to " << String() << " and killed: " << killed);
 
+	ResetDamageCache();
+
 	if(killed >= GetCount())
 	{
 	    dead += GetCount();
@@ -831,6 +856,8 @@ void Battle::Unit::PostKilledAction(void)
     if(head) head->SetUnit(NULL);
     if(tail) tail->SetUnit(NULL);
 
+    ResetDamageCache();
+
     DEBUG(DBG_BATTLE, DBG_TRACE, String() << ", is dead...");
     // possible also..
 }
@@ -839,6 +866,8 @@ u32 Battle::Unit::Resurrect(u32 points, bool allow_overflow, bool skip_dead)
 {
     u32 resurrect = Monster::GetCountFromHitPoints(*this, hp + points) - GetCount();
 
+    ResetDamageCache();
+
     SetCount(GetCount() + resurrect);
     hp += points;
 
@@ -973,6 +1002,8 @@ bool Battle::Unit::ApplySpell(const Spell & spell, const HeroBase* hero, TargetI
 
     DEBUG(DBG_BATTLE, DBG_TRACE, spell.GetName() << " to " << String());
 
+    ResetDamageCache();
+
     u16 spoint = hero ? hero->GetPower() : 3;
 
     if(spell.isDamage())
@@ -1186,7 +1217,8 @@ s32 Battle::Unit::GetScoreQuality(const Unit & defender) const
     const Unit & attacker = *this;
 
     // initial value: (hitpoints)
-    const u32 & damage = (attacker.GetDamageMin(defender) + attacker.GetDamageMax(defender)) / 2;
+    const DamageInfo info = attacker.GetDamageInfo(defender);
+    const u32 & damage = (info.min + info.max) / 2;
     const u32 & kills = defender.HowManyWillKilled(attacker.isTwiceAttack() ? damage * 2 : damage);
     float res = kills * static_cast<Monster>(defender).GetHitPoints();
     bool noscale = false;
@@ -1404,6 +1436,19 @@ void Battle::Unit::SpellModesAction(const Spell & spell, u8 duration, const Hero
 }
 
 void Battle::Unit::SpellApplyDamage(const Spell & spell, u8 spoint, const HeroBase* hero, TargetInfo & target)
+{
+    const u32 dmg = CalculateSpellDamage(spell, spoint, hero, target.damage);
+
+    // apply damage
+    if(dmg)
+    {
+	target.damage = dmg;
+	target.killed = ApplyDamage(dmg);
+	if(target.defender && target.defender->Modes(SP_BLIND)) target.defender->ResetBlind();
+    }
+}
+
+u32 Battle::Unit::CalculateSpellDamage(const Spell & spell, u8 spoint, const HeroBase* hero, u32 order) const
 {
     u32 dmg = spell.Damage() * spoint;
 
@@ -1521,7 +1566,7 @@ void Battle::Unit::SpellApplyDamage(const Spell & spell, u8 spoint, const HeroBa
     		acount = myhero ? myhero->HasArtifact(Artifact::LIGHTNING_HELM) : 0;
 		if(acount) dmg /= acount * 2;
 		// update orders damage
-		switch(target.damage)
+		switch(order)
 		{
 		    case 0: 	break;
 		    case 1:	dmg /= 2; break;
@@ -1542,13 +1587,7 @@ void Battle::Unit::SpellApplyDamage(const Spell & spell, u8 spoint, const HeroBa
 	}
     }
 
-    // apply damage
-    if(dmg)
-    {
-	target.damage = dmg;
-	target.killed = ApplyDamage(dmg);
-	if(target.defender && target.defender->Modes(SP_BLIND)) target.defender->ResetBlind();
-    }
+    return dmg;
 }
 
 void Battle::Unit::SpellRestoreAction(const Spell & spell, u8 spoint, const HeroBase* hero)
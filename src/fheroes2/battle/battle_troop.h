@@ -118,6 +118,7 @@ namespace Battle
 	u8	GetSpeed(bool skip_standing_check) const;
 	u8	GetControl(void) const;
 	u32	GetDamage(const Unit &) const;
+	DamageInfo GetDamageInfo(const Unit &) const;
 	s32	GetScoreQuality(const Unit &) const;
 	u32	GetDead(void) const;
 	u32	GetHitPoints(void) const;
@@ -127,6 +128,7 @@ namespace Battle
 	u32	GetDamageMin(const Unit &) const;
 	u32	GetDamageMax(const Unit &) const;
 	u32     CalculateDamageUnit(const Unit &, float) const;
+	u32	CalculateSpellDamage(const Spell &, u8, const HeroBase*, u32 order = 0) const;
 	bool	ApplySpell(const Spell &, const HeroBase* hero, TargetInfo &);
 	bool	AllowApplySpell(const Spell &, const HeroBase* hero, std::string* msg = NULL) const;
 	void	PostAttackAction(Unit &);
@@ -32,6 +32,7 @@
 #include "cursor.h"
 #include "settings.h"
 #include "maps_fileinfo.h"
+#include "game_io.h"
 #include "interface_list.h"
 #include "pocketpc.h"
 #include "world.h"
@@ -39,6 +40,7 @@
 
 bool SelectFileListSimple(const std::string &, std::string &, bool);
 void RedrawExtraInfo(const Point &, const std::string &, const std::string &);
+void RedrawThumbnail(const Rect &, const Game::SAVInfoList &, const std::string &);
 
 class FileInfoListBox : public Interface::ListBox<Maps::FileInfo>
 {
@@ -143,15 +145,16 @@ size_t GetInsertPosition(const std::string & name, u16 cx, u16 center)
     return 0;
 }
 
-MapsFileInfoList GetSortedMapsFileInfoList(void)
+/* from the saves dir index: see Game::GetSAVInfoList */
+MapsFileInfoList GetSortedMapsFileInfoList(const Game::SAVInfoList & saves)
 {
-    ListFiles list1;
-    list1.ReadDir(Settings::GetSaveDir(), ".sav", false);
+    MapsFileInfoList list2;
+    list2.reserve(saves.size());
+
+    for(Game::SAVInfoList::const_iterator
+	it = saves.begin(); it != saves.end(); ++it)
+	list2.push_back((*it).info);
 
-    MapsFileInfoList list2(list1.size());
-    int ii = 0;
-    for(ListFiles::const_iterator itd = list1.begin(); itd != list1.end(); ++itd, ++ii) if(!list2[ii].ReadSAV(*itd)) --ii;
-    if(static_cast<size_t>(ii) != list2.size()) list2.resize(ii);
     std::sort(list2.begin(), list2.end(), Maps::FileInfo::FileSorting);
 
     return list2;
@@ -217,9 +220,16 @@ bool SelectFileListSimple(const std::string & header, std::string & result, bool
 
     bool edit_mode = false;
 
-    MapsFileInfoList lists = GetSortedMapsFileInfoList();
+    const Game::SAVInfoList saves = Game::GetSAVInfoList(Settings::GetSaveDir());
+    MapsFileInfoList lists = GetSortedMapsFileInfoList(saves);
     FileInfoListBox listbox(rt, result, edit_mode);
 
+    // thumbnail: at right of the panel, if place
+    const Rect preview(rt.x + rt.w + 4, rt.y + 55, Game::THUMBNAILSIZE + 2, Game::THUMBNAILSIZE + 2);
+    Background back_preview(preview);
+    const bool thumbnail = !pocket && preview.x + preview.w <= display.w();
+    if(thumbnail) back_preview.Save();
+
     listbox.RedrawBackground(rt);
     listbox.SetScrollButtonUp(ICN::REQUESTS, 5, 6, Point(rt.x + 327, rt.y + 55));
     listbox.SetScrollButtonDn(ICN::REQUESTS, 7, 8, Point(rt.x + 327, rt.y + (pocket ? 117 : 257)));
@@ -258,6 +268,7 @@ bool SelectFileListSimple(const std::string & header, std::string & result, bool
 
     listbox.Redraw();
     RedrawExtraInfo(rt, header, filename);
+    if(thumbnail) RedrawThumbnail(preview, saves, listbox.isSelected() ? listbox.GetCurrent().file : "");
 
     buttonOk.Draw();
     buttonCancel.Draw();
@@ -333,6 +344,8 @@ bool SelectFileListSimple(const std::string & header, std::string & result, bool
 	    else
 		RedrawExtraInfo(rt, header, filename);
 
+	    if(thumbnail) RedrawThumbnail(preview, saves, listbox.isSelected() ? listbox.GetCurrent().file : "");
+
 	    buttonOk.Draw();
 	    buttonCancel.Draw();
 	    cursor.Show();
@@ -341,11 +354,36 @@ bool SelectFileListSimple(const std::string & header, std::string & result, bool
     }
 
     cursor.Hide();
+    if(thumbnail) back_preview.Restore();
     back.Restore();
 
     return result.size();
 }
 
+void RedrawThumbnail(const Rect & dst, const Game::SAVInfoList & saves, const std::string & file)
+{
+    Display & display = Display::Get();
+    Game::SAVInfoList::const_iterator it = saves.begin();
+
+    for(; it != saves.end(); ++it) if((*it).info.file == file) break;
+
+    display.FillRect(0, dst);
+
+    if(it == saves.end() || (*it).thumbnail.empty()) return;
+
+    const std::vector<u8> & pixels = (*it).thumbnail;
+    const u16 size = Game::THUMBNAILSIZE;
+    Surface sf(size, size);
+
+    sf.Lock();
+    for(u16 yy = 0; yy < size; ++yy)
+	for(u16 xx = 0; xx < size; ++xx)
+	    sf.SetPixel(xx, yy, sf.GetColorIndex(pixels[yy * size + xx]));
+    sf.Unlock();
+
+    sf.Blit(dst.x + 1, dst.y + 1, display);
+}
+
 void RedrawExtraInfo(const Point & dst, const std::string & header, const std::string & filename)
 {
     Text text(header, Font::BIG);
@@ -111,6 +111,11 @@ void SettingsListBox::ActionListSingleClick(u32 & item)
 		    conf.ExtResetModes(Settings::GAME_AUTOSAVE_ON);
 		break;
 
+	    case Settings::GAME_AUTOSAVE_DELTA:
+		if(conf.ExtModes(Settings::GAME_AUTOSAVE_DELTA))
+		    conf.ExtSetModes(Settings::GAME_AUTOSAVE_ON);
+		break;
+
 	    case Settings::WORLD_GUARDIAN_TWO_DEFENSE:
 		if(conf.ExtModes(Settings::WORLD_GUARDIAN_TWO_DEFENSE))
 		    conf.ExtSetModes(Settings::WORLD_ALLOW_SET_GUARDIAN);
@@ -178,6 +183,7 @@ void Dialog::ExtSettings(bool readonly)
 
     states.push_back(Settings::GAME_AUTOSAVE_ON);
     states.push_back(Settings::GAME_AUTOSAVE_BEGIN_DAY);
+    states.push_back(Settings::GAME_AUTOSAVE_DELTA);
 
     if(conf.VideoMode().w == 640 && conf.VideoMode().h == 480)
 	states.push_back(Settings::GAME_USE_FADE);
@@ -31,6 +31,7 @@
 #include "agg.h"
 #include "cursor.h"
 #include "game.h"
+#include "game_io.h"
 #include "test.h"
 #include "images_pack.h"
 #include "zzlib.h"
@@ -52,6 +53,9 @@ int PrintHelp(const char *basename)
 #ifndef BUILD_RELEASE
     VERBOSE("  -d\tdebug mode");
 #endif
+    VERBOSE("  -b\tbattle simulation batch file (without video)");
+    VERBOSE("  -o\tbattle simulation csv results (default: stdout)");
+    VERBOSE("  -c\tfill the maps cache for the maps directory (without video)");
     VERBOSE("  -h\tprint this help and exit");
 
     return EXIT_SUCCESS;
@@ -72,6 +76,7 @@ int main(int argc, char **argv)
 {
 	Settings & conf = Settings::Get();
 	int test = 0;
+	std::string batch, output, mapscache;
 
 	DEBUG(DBG_ALL, DBG_INFO, "Free Heroes II, " + conf.GetVersion());
 
@@ -87,7 +92,7 @@ int main(int argc, char **argv)
 	// getopt
 	{
 	    int opt;
-	    while((opt = getopt(argc, argv, "hest:d:")) != -1)
+	    while((opt = getopt(argc, argv, "hest:d:b:o:c:")) != -1)
     		switch(opt)
                 {
 #ifdef WITH_EDITOR
@@ -104,6 +109,18 @@ int main(int argc, char **argv)
                 	conf.SetDebug(optarg ? String::ToInt(optarg) : 0);
                 	break;
 #endif
+                    case 'b':
+			batch = optarg;
+			break;
+
+                    case 'o':
+			output = optarg;
+			break;
+
+                    case 'c':
+			mapscache = optarg;
+			break;
+
                     case '?':
                     case 'h': return PrintHelp(argv[0]);
 
@@ -111,6 +128,28 @@ int main(int argc, char **argv)
 		}
 	}
 
+	// headless battle simulation: timer only
+	if(batch.size())
+	{
+	    Rand::Init();
+
+	    if(! SDL::Init(INIT_TIMER)) return EXIT_FAILURE;
+	    std::atexit(SDL::Quit);
+
+	    return Game::BattleSimulation(batch, output) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	// headless maps cache: timer only
+	if(mapscache.size())
+	{
+	    Rand::Init();
+
+	    if(! SDL::Init(INIT_TIMER)) return EXIT_FAILURE;
+	    std::atexit(SDL::Quit);
+
+	    return Game::PrewarmMapsCache(mapscache) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
 	if(conf.SelectVideoDriver().size()) SetVideoDriver(conf.SelectVideoDriver());
 
 	// random init
@@ -321,6 +360,7 @@ void InitHomeDir(void)
 	const std::string home_maps  = home + SEPARATOR + std::string("maps");
 	const std::string home_files = home + SEPARATOR + std::string("files");
 	const std::string home_files_save = home_files + SEPARATOR + std::string("save");
+	const std::string home_files_cache = home_files + SEPARATOR + std::string("cache");
 
 	if(! IsDirectory(home))
 	    MKDIR(home.c_str());
@@ -333,6 +373,9 @@ void InitHomeDir(void)
 
 	if(IsDirectory(home_files, true) && ! IsDirectory(home_files_save))
 	    MKDIR(home_files_save.c_str());
+
+	if(IsDirectory(home_files, true) && ! IsDirectory(home_files_cache))
+	    MKDIR(home_files_cache.c_str());
     }
 }
 
@@ -24,6 +24,7 @@
 #define H2GAME_H
 
 #include <string>
+#include <iosfwd>
 #include "rect.h"
 #include "types.h"
 #include "gamedefs.h"
@@ -217,6 +218,9 @@ namespace Game
 
     menu_t Testing(u8);
 
+    bool BattleSimulation(const std::string & batch, const std::string & output);
+    bool BattleSimulation(std::istream & batch, std::ostream & csv);
+
     void DrawInterface(void);
 
     void SetFixVideoMode(void);
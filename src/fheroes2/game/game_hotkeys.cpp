@@ -30,6 +30,7 @@
 #include "agg.h"
 #include "settings.h"
 #include "game.h"
+#include "ai_profile.h"
 
 namespace Game
 {
@@ -314,5 +315,7 @@ void Game::KeyboardGlobalFilter(int sym, u16 mod)
     else
     if(sym == key_events[EVENT_SYSTEM_DEBUG2])
     {
+	// AI turns profile on demand
+	AI_PROFILE_SAVE(Settings::GetSaveDir() + SEPARATOR + "ai_profile_" + GetString(std::time(0)) + ".json");
     }
 }
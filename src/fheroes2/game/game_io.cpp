@@ -20,7 +20,10 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <sys/stat.h>
+#include <cstdio>
 #include <fstream>
+#include <iterator>
 #include <sstream>
 #include <cstring>
 #include <ctime>
@@ -40,8 +43,18 @@
 #include "game_static.h"
 #include "game_focus.h"
 #include "monster.h"
+#include "thread.h"
+#include "dir.h"
+#include "interface_radar.h"
 
 static u16 SAV2ID = 0xFF02;
+static u16 SAV3ID = 0xFF03;
+static u16 SAVIDXID = 0xFF10;
+
+namespace GameStatic
+{
+    extern u32 uniq;
+}
 
 namespace Game
 {
@@ -80,236 +93,1291 @@ namespace Game
     {
 	return msg >> hdr.status >> hdr.info;
     }
-}
 
-bool Game::Save(const std::string &fn)
-{
-    DEBUG(DBG_GAME, DBG_INFO, fn);
-    const bool autosave = (GetBasename(fn) == "autosave.sav");
-    const Settings & conf = Settings::Get();
+    /* SAV3: the table of contents, the sections are compressed and checked apart */
+    struct SectionSAV
+    {
+	enum { IS_COMPRESS = 0x0001 };
 
-    // ask overwrite?
-    if(IsFile(fn) &&
-	((!autosave && conf.ExtGameRewriteConfirm()) || (autosave && Settings::Get().ExtGameAutosaveConfirm())) &&
-	Dialog::NO == Dialog::Message("", _("Are you sure you want to overwrite the save with this name?"), Font::BIG, Dialog::YES|Dialog::NO))
+	SectionSAV() : tag(0), offset(0), size(0), rawsize(0), checksum(0), flags(0), data(0), valid(false)
+	{
+	}
+
+	void		Encode(bool compress);
+	void		Decode(void);
+
+	u32		tag;
+	u32		offset;
+	u32		size;
+	u32		rawsize;
+	u32		checksum;
+	u16		flags;
+	StreamBuf	data;
+#ifdef WITH_ZLIB
+	ZStreamBuf	zdata;
+#endif
+	bool		valid;
+	SDL::Thread	thread;
+    };
+
+    typedef std::vector<SectionSAV> SectionsSAV;
+
+    StreamBase & operator<< (StreamBase & msg, const SectionSAV & section)
     {
-	return false;
+	return msg << section.tag << section.offset << section.size <<
+	    section.rawsize << section.checksum << section.flags;
     }
 
-    std::ofstream fs(fn.c_str(), std::ios::binary);
+    StreamBase & operator>> (StreamBase & msg, SectionSAV & section)
+    {
+	return msg >> section.tag >> section.offset >> section.size >>
+	    section.rawsize >> section.checksum >> section.flags;
+    }
 
-    if(fs.is_open())
+    std::ostream & operator<< (std::ostream & os, SectionSAV & section)
+    {
+#ifdef WITH_ZLIB
+	if(section.flags & SectionSAV::IS_COMPRESS)
+	    return os << section.zdata;
+#endif
+	return os << section.data;
+    }
+
+    std::istream & operator>> (std::istream & is, SectionSAV & section)
+    {
+#ifdef WITH_ZLIB
+	if(section.flags & SectionSAV::IS_COMPRESS)
+	    return is >> section.zdata;
+#endif
+	return is >> section.data;
+    }
+
+    int SectionEncode(void* param)
+    {
+	SectionSAV & section = *static_cast<SectionSAV*>(param);
+	section.Encode(section.tag != SECTION_HEADER);
+	return 0;
+    }
+
+    int SectionDecode(void* param)
+    {
+	static_cast<SectionSAV*>(param)->Decode();
+	return 0;
+    }
+
+    /* threads not available: run in place */
+    void SectionsRun(SectionsSAV & sections, int (*fn)(void*))
+    {
+	for(SectionsSAV::iterator
+	    it = sections.begin(); it != sections.end(); ++it)
+	    (*it).thread.Create(fn, &(*it));
+
+	for(SectionsSAV::iterator
+	    it = sections.begin(); it != sections.end(); ++it)
+	{
+	    if((*it).thread.IsRun())
+		(*it).thread.Wait();
+	    else
+		fn(&(*it));
+	}
+    }
+
+    std::string SectionName(u32 tag)
+    {
+	std::string res(4, ' ');
+	for(u8 ii = 0; ii < 4; ++ii) res[ii] = static_cast<char>(tag >> (24 - 8 * ii));
+	return res;
+    }
+
+    SectionSAV* FindSection(SectionsSAV & sections, u32 tag)
+    {
+	for(SectionsSAV::iterator
+	    it = sections.begin(); it != sections.end(); ++it)
+	    if((*it).tag == tag) return &(*it);
+	return NULL;
+    }
+
+    bool ReadSectionsTOC(std::istream & is, SectionsSAV & sections)
+    {
+	StreamBuf toc(1024);
+	u32 count = 0;
+
+	is >> toc;
+	toc >> count;
+
+	if(toc.fail() || count > 64)
+	    return false;
+
+	sections.resize(count);
+
+	for(SectionsSAV::iterator
+	    it = sections.begin(); it != sections.end(); ++it)
+	    toc >> *it;
+
+	return ! toc.fail();
+    }
+
+    bool ReadSection(std::istream & is, SectionSAV & section)
     {
-	StreamBuf info(1024);
-	StreamBuf gdata((Maps::MEDIUM < conf.MapsWidth() ? 1024 :512) * 1024);
-	if(! autosave) Game::SetLastSavename(fn);
+	is.clear();
+	is.seekg(0, std::ios_base::end);
+	const std::streamoff length = is.tellg();
 
-	info << GetString(GetLoadVersion()) << GetLoadVersion() <<
+	// the declared size: inside the file
+	if(length < 0 || section.offset > length ||
+	    section.size > length - section.offset)
+	    return false;
+
+	is.seekg(section.offset, std::ios_base::beg);
+	is >> section;
+
+	return is.good() &&
+	    static_cast<std::streamoff>(is.tellg()) == static_cast<std::streamoff>(section.offset) + section.size;
+    }
+
+    bool CheckHeaderSAV(const HeaderSAV & header, u16 binver)
+    {
+	if((header.status & HeaderSAV::IS_LOYALTY) &&
+	    !Settings::Get().PriceLoyaltyVersion())
+	{
+	    Dialog::Message("Warning", _("This file is saved in the \"Price Loyalty\" version.\nSome items may be unavailable."), Font::BIG, Dialog::OK);
+	}
+
+	// check version: false
+	if(binver > CURRENT_FORMAT_VERSION || binver < LAST_FORMAT_VERSION)
+	{
+	    std::ostringstream os;
+	    os << "usupported save format: " << binver << std::endl <<
+     		"game version: " << CURRENT_FORMAT_VERSION << std::endl <<
+     		"last version: " << LAST_FORMAT_VERSION;
+ 	    Dialog::Message("Error", os.str(), Font::BIG, Dialog::OK);
+ 	    return false;
+	}
+
+	return true;
+    }
+
+    StreamBase & operator<< (StreamBase & msg, const SAVInfo & sav)
+    {
+	return msg << sav.info << sav.mtime << sav.size << sav.thumbnail;
+    }
+
+    StreamBase & operator>> (StreamBase & msg, SAVInfo & sav)
+    {
+	return msg >> sav.info >> sav.mtime >> sav.size >> sav.thumbnail;
+    }
+
+    StreamBase & operator<< (StreamBase & msg, const KingdomInfo & kingdom)
+    {
+	return msg << kingdom.color << kingdom.control << kingdom.race <<
+	    kingdom.heroes << kingdom.castles << kingdom.gold;
+    }
+
+    StreamBase & operator>> (StreamBase & msg, KingdomInfo & kingdom)
+    {
+	return msg >> kingdom.color >> kingdom.control >> kingdom.race >>
+	    kingdom.heroes >> kingdom.castles >> kingdom.gold;
+    }
+
+    enum { SECTIONSMAX = 16 };
+
+    SectionSAV & AddSection(SectionsSAV & sections, u32 tag)
+    {
+	sections.push_back(SectionSAV());
+	sections.back().tag = tag;
+	return sections.back();
+    }
+
+    /* all sections without the world */
+    void AddGameSections(SectionsSAV & sections)
+    {
+	const Settings & conf = Settings::Get();
+	std::vector<u8> thumbnail;
+
+	AddSection(sections, SECTION_HEADER).data << GetString(GetLoadVersion()) << GetLoadVersion() <<
 		HeaderSAV(conf.CurrentFileInfo(), conf.PriceLoyaltyVersion());
-	gdata << GetLoadVersion() << World::Get() << Settings::Get() <<
-	    GameOver::Result::Get() << GameStatic::Data::Get() << MonsterStaticData::Get() << SAV2ID; // eof marker
+	AddSection(sections, SECTION_SETTINGS).data << Settings::Get();
+	AddSection(sections, SECTION_GAMEOVER).data << GameOver::Result::Get();
+	AddSection(sections, SECTION_STATIC).data << GameStatic::Data::Get();
+	AddSection(sections, SECTION_MONSTERS).data << MonsterStaticData::Get();
 
-	fs << static_cast<char>(SAV2ID >> 8) << static_cast<char>(SAV2ID) << info;
+	// for the saves list: the player view
+	Interface::Radar::GetThumbnail(thumbnail, THUMBNAILSIZE, Players::FriendColors());
+	AddSection(sections, SECTION_THUMBNAIL).data << static_cast<u16>(THUMBNAILSIZE) << thumbnail;
 
-#ifdef WITH_ZLIB
-	ZStreamBuf zdata;
-	zdata << gdata;
+	// for the saves list: the kingdoms in game
+	const Colors colors(conf.GetPlayers().GetColors());
+	KingdomInfoList kingdoms;
 
-	if(! zdata.fail())
-	    fs << zdata;
-	else
-	    fs << gdata;
-#else
-	fs << gdata;
-#endif
+	for(Colors::const_iterator
+	    it = colors.begin(); it != colors.end(); ++it)
+	{
+	    const Kingdom & kingdom = world.GetKingdom(*it);
+	    KingdomInfo info;
 
-	return fs.good();
+	    if(! kingdom.isPlay()) continue;
+
+	    info.color = kingdom.GetColor();
+	    info.control = kingdom.GetControl();
+	    info.race = kingdom.GetRace();
+	    info.heroes = kingdom.GetHeroes().size();
+	    info.castles = kingdom.GetCastles().size();
+	    info.gold = kingdom.GetFunds().gold;
+	    kingdoms.push_back(info);
+	}
+
+	AddSection(sections, SECTION_KINGDOMS).data << kingdoms;
     }
 
-    return false;
-}
+    bool WriteSections(const std::string & fn, SectionsSAV & sections)
+    {
+	std::ofstream fs(fn.c_str(), std::ios::binary);
 
-bool Game::Load(const std::string & fn)
-{
-    DEBUG(DBG_GAME, DBG_INFO, fn);
-    bool result = false;
-    const Settings & conf = Settings::Get();
-    // loading info
-    Game::ShowLoadMapsText();
+	if(! fs.is_open())
+	    return false;
 
-    std::ifstream fs(fn.c_str(), std::ios::binary);
+	// compress and checksum in parallel
+	SectionsRun(sections, SectionEncode);
 
-    if(fs.is_open())
+	StreamBuf toc(1024);
+	toc << static_cast<u32>(sections.size());
+	for(SectionsSAV::const_iterator
+	    it = sections.begin(); it != sections.end(); ++it)
+	    toc << *it;
+
+	fs << static_cast<char>(SAV3ID >> 8) << static_cast<char>(SAV3ID);
+
+	// the table of contents has a fixed size: written again with the offsets
+	const std::streampos tocpos = fs.tellp();
+	fs << toc;
+
+	for(SectionsSAV::iterator
+	    it = sections.begin(); it != sections.end(); ++it)
+	{
+	    (*it).offset = fs.tellp();
+	    fs << *it;
+	    (*it).size = static_cast<u32>(fs.tellp()) - (*it).offset;
+	}
+
+	toc.reset();
+	toc << static_cast<u32>(sections.size());
+	for(SectionsSAV::const_iterator
+	    it = sections.begin(); it != sections.end(); ++it)
+	    toc << *it;
+
+	fs.seekp(tocpos);
+	fs << toc;
+
+	return fs.good();
+    }
+
+    bool ReadSections(const std::string & fn, SectionsSAV & sections)
     {
+	std::ifstream fs(fn.c_str(), std::ios::binary);
+
+	if(! fs.is_open())
+	    return false;
+
 	char major, minor;
 	fs >> std::noskipws >> major >> minor;
 	const u16 savid = (static_cast<u16>(major) << 8) | static_cast<u16>(minor);
 
-	// check version sav file
-	if(savid == SAV2ID)
-	{
-	    std::string strver;
-	    u16 binver = 0;
-	    StreamBuf hinfo(1024);
-	    StreamBuf gdata((Maps::MEDIUM < conf.MapsWidth() ? 1024 :512) * 1024);
-	    HeaderSAV header;
+	if(savid != SAV3ID || ! ReadSectionsTOC(fs, sections))
+	    return false;
 
-	    fs >> hinfo;
+	for(SectionsSAV::iterator
+	    it = sections.begin(); it != sections.end(); ++it)
+	    if(! ReadSection(fs, *it)) return false;
 
-	    if(hinfo.fail())
-	    {
-		DEBUG(DBG_GAME, DBG_INFO, fn << ", hinfo" << " read: error");
-		return false;
-	    }
+	SectionsRun(sections, SectionDecode);
 
-	    hinfo >> strver >> binver >> header;
+	for(SectionsSAV::const_iterator
+	    it = sections.begin(); it != sections.end(); ++it)
+	    if(! (*it).valid) return false;
 
-#ifndef WITH_ZLIB
-	    if(header.status & HeaderSAV::IS_COMPRESS)
-	    {
-		DEBUG(DBG_GAME, DBG_INFO, fn << ", zlib: unsupported");
-		return false;
-	    }
-	    else
-#else
-	    if(header.status & HeaderSAV::IS_COMPRESS)
-	    {
-		ZStreamBuf zdata;
-		fs >> zdata;
+	return true;
+    }
 
-		if(zdata.fail())
-		{
-		    DEBUG(DBG_GAME, DBG_INFO, fn << ", zdata" << " read: error");
-		    return false;
-		}
+    /* autosave deltas: the tiles checksums of the last base */
+    struct AutosaveBase
+    {
+	AutosaveBase() : id(0), day(0), width(0), height(0) {}
 
-		zdata >> gdata;
+	u32		id;
+	u16		day;
+	u16		width;
+	u16		height;
+	std::vector<u32> tiles;
+    };
 
-		if(gdata.fail())
-		{
-		    DEBUG(DBG_GAME, DBG_INFO, ", uncompress: error");
-		    return false;
-		}
-	    }
-	    else
-#endif
-	    {
-		fs >> gdata;
+    AutosaveBase & GetAutosaveBase(void)
+    {
+	static AutosaveBase base;
+	return base;
+    }
 
-		if(gdata.fail())
-		{
-		    DEBUG(DBG_GAME, DBG_INFO, fn << ", gdata" << " read: error");
-		    return false;
-		}
-	    }
+    std::string GetDeltaName(const std::string & fn)
+    {
+	const size_t dotpos = fn.rfind('.');
+	return (dotpos != std::string::npos ? fn.substr(0, dotpos) : fn) + ".dlt";
+    }
 
-	    if((header.status & HeaderSAV::IS_LOYALTY) &&
-		!conf.PriceLoyaltyVersion())
-	    {
-		Dialog::Message("Warning", _("This file is saved in the \"Price Loyalty\" version.\nSome items may be unavailable."), Font::BIG, Dialog::OK);
-	    }
+    bool CheckAutosaveBase(const std::string & fn, u32 id)
+    {
+	StreamBuf data(0);
+	u32 baseid = 0;
 
-	    gdata >> binver;
+	if(! LoadSAVSection(fn, SECTION_BASE, data))
+	    return false;
 
-	    // check version: false
-	    if(binver > CURRENT_FORMAT_VERSION || binver < LAST_FORMAT_VERSION)
-	    {
-		std::ostringstream os;
-		os << "usupported save format: " << binver << std::endl <<
-     		"game version: " << CURRENT_FORMAT_VERSION << std::endl <<
-     		"last version: " << LAST_FORMAT_VERSION;
- 		Dialog::Message("Error", os.str(), Font::BIG, Dialog::OK);
- 		return false;
-	    }
+	data >> baseid;
+	return ! data.fail() && baseid == id;
+    }
 
-	    SetLoadVersion(binver);
-	    u16 end_check = 0;
+    /* the base world with the changed tiles and the states from the delta */
+    bool ReplayDelta(SectionSAV & world, SectionSAV & base, SectionsSAV & delta, StreamBuf & result)
+    {
+	SectionSAV* tiles = FindSection(delta, SECTION_TILES);
+	SectionSAV* states = FindSection(delta, SECTION_STATES);
+	std::vector<u32> lengths;
+	std::map<s32, std::vector<u8> > changes;
+	u32 id = 0;
+	u32 deltaid = 0;
+	u32 count = 0;
 
-	    if(GetLoadVersion() < FORMAT_VERSION_2830)
-	    {
-		gdata >> Settings::Get() >> World::Get() >> GameOver::Result::Get() >>
-		    GameStatic::Data::Get() >> MonsterStaticData::Get() >> end_check;
-	    }
-	    else
-	    {
-		gdata >> World::Get() >> Settings::Get() >> GameOver::Result::Get() >>
-		    GameStatic::Data::Get() >> MonsterStaticData::Get() >> end_check;
-	    }
+	if(! tiles || ! states)
+	    return false;
+
+	base.data >> id >> lengths;
+	tiles->data >> deltaid >> count;
+
+	if(base.data.fail() || id != deltaid)
+	    return false;
+
+	for(u32 ii = 0; ii < count && ! tiles->data.fail(); ++ii)
+	{
+	    s32 index = 0;
+	    tiles->data >> index;
+	    tiles->data >> changes[index];
+	}
+
+	if(tiles->data.fail())
+	    return false;
+
+	// world: size, tiles count, tiles, states
+	const char* ptr = world.data.data();
+	const size_t size = world.data.size();
 
-	    if(end_check == SAV2ID)
+	// the tiles offset: the size and the tiles count are read from a copy
+	StreamBuf prefix(world.data);
+	Size sz;
+	u32 tilescount = 0;
+
+	prefix >> sz >> tilescount;
+
+	if(prefix.fail() || tilescount != lengths.size())
+	    return false;
+
+	size_t pos = size - prefix.size();
+
+	for(size_t ii = 0; ii < pos; ++ii)
+	    result << ptr[ii];
+
+	for(u32 index = 0; index < lengths.size(); ++index)
+	{
+	    std::map<s32, std::vector<u8> >::const_iterator it = changes.find(index);
+
+	    if(pos + lengths[index] > size)
+		return false;
+
+	    if(it != changes.end())
 	    {
-		SetLoadVersion(CURRENT_FORMAT_VERSION);
-		result = true;
+		for(std::vector<u8>::const_iterator
+		    itb = (*it).second.begin(); itb != (*it).second.end(); ++itb)
+		    result << static_cast<char>(*itb);
 	    }
 	    else
-	    {
-		DEBUG(DBG_GAME, DBG_WARN, "invalid load file: " << fn);
-	    }
+		for(size_t ii = pos; ii < pos + lengths[index]; ++ii)
+		    result << ptr[ii];
+
+	    pos += lengths[index];
 	}
-	else
-	    result = false;
+
+	const char* sptr = states->data.data();
+	for(size_t ii = 0; ii < states->data.size(); ++ii)
+	    result << sptr[ii];
+
+	return true;
     }
 
-    if(result)
+    /* the maps cache: one file for a maps, the key of the last setup */
+    std::string GetMapsCacheName(const std::string & fn)
     {
-	Settings & conf = Settings::Get();
-	Game::SetLastSavename(fn);
-	conf.SetGameType(conf.GameType() | Game::TYPE_LOADFILE);
+	const std::string dir = Settings::GetWriteableDir("cache");
+	return dir.empty() ? dir : dir + SEPARATOR + GetBasename(fn) + ".mpc";
     }
 
-    return result;
-}
+    bool CheckMapsCache(const std::string & cache, u32 key)
+    {
+	StreamBuf data(0);
+	u32 cachekey = 0;
+	u16 binver = 0;
 
-bool Game::LoadSAV2FileInfo(const std::string & fn,  Maps::FileInfo & finfo)
-{
-    std::ifstream fs(fn.c_str(), std::ios::binary);
+	if(! LoadSAVSection(cache, SECTION_MAPSKEY, data))
+	    return false;
 
-    if(fs.is_open())
+	data >> cachekey >> binver;
+	return ! data.fail() && cachekey == key && binver == CURRENT_FORMAT_VERSION;
+    }
+
+    /* the index key: the save with its autosave delta */
+    bool StatSAV(const std::string & fn, u32 & mtime, u32 & size)
     {
-	char major, minor;
-	fs >> std::noskipws >> major >> minor;
-	const u16 savid = (static_cast<u16>(major) << 8) | static_cast<u16>(minor);
+	struct stat st;
+	if(stat(fn.c_str(), &st)) return false;
 
-	// check version sav file
-	if(savid == SAV2ID)
+	mtime = st.st_mtime;
+	size = st.st_size;
+
+	if(0 == stat(GetDeltaName(fn).c_str(), &st))
 	{
-	    HeaderSAV header;
-	    StreamBuf hinfo(1024);
-	    std::string strver;
-	    u16 binver;
+	    if(mtime < static_cast<u32>(st.st_mtime)) mtime = st.st_mtime;
+	    size += st.st_size;
+	}
 
-	    fs >> hinfo;
+	return true;
+    }
 
-	    if(hinfo.fail())
-	    {
-		DEBUG(DBG_GAME, DBG_INFO, fn << ", hinfo" << " read: error");
-		return false;
-	    }
+    /* the header and the thumbnail: from the delta, if it is from this base */
+    bool ReadSAVInfo(const std::string & fn, SAVInfo & sav)
+    {
+	if(! StatSAV(fn, sav.mtime, sav.size) || ! LoadSAV2FileInfo(fn, sav.info))
+	    return false;
 
-	    hinfo >> strver >> binver >> header;
+	LoadSAVThumbnail(fn, sav.thumbnail);
 
-	    // hide: unsupported version
-	    if(binver > CURRENT_FORMAT_VERSION || binver < LAST_FORMAT_VERSION)
-		return false;
+	StreamBuf base(0);
+	StreamBuf tiles(0);
+	u32 baseid = 0;
+	u32 deltaid = 0;
+	const std::string delta = GetDeltaName(fn);
 
-#ifndef WITH_ZLIB
-	    // check: compress game data
-	    if(header.status & HeaderSAV::IS_COMPRESS)
+	if(LoadSAVSection(fn, SECTION_BASE, base) &&
+	    LoadSAVSection(delta, SECTION_TILES, tiles))
+	{
+	    base >> baseid;
+	    tiles >> deltaid;
+
+	    if(! base.fail() && ! tiles.fail() && baseid == deltaid &&
+		LoadSAV2FileInfo(delta, sav.info))
 	    {
-		DEBUG(DBG_GAME, DBG_INFO, fn << ", zlib: unsupported");
-		return false;
+		sav.info.file = fn;
+		LoadSAVThumbnail(delta, sav.thumbnail);
 	    }
-#endif
-
-	    finfo = header.info;
-	    finfo.file = fn;
-
-	    return true;
 	}
 
-	return false;
+	return true;
     }
 
-    return false;
-}
+    void ReadSAVIndex(const std::string & dir, std::map<std::string, SAVInfo> & index)
+    {
+	const std::string idxname = dir + SEPARATOR + "saves.idx";
+	std::ifstream is(idxname.c_str(), std::ios::binary);
+
+	if(is.is_open())
+	{
+	    StreamBuf sb(0);
+	    u16 idxid = 0;
+	    u16 binver = 0;
+	    u32 count = 0;
 
+	    is >> sb;
+	    sb >> idxid >> binver >> count;
+
+	    // other game version: rebuild
+	    if(! sb.fail() && idxid == SAVIDXID && binver == CURRENT_FORMAT_VERSION)
+		for(u32 ii = 0; ii < count; ++ii)
+	    {
+		SAVInfo sav;
+		sb >> sav;
+		if(sb.fail()) break;
+
+		sav.info.file = dir + SEPARATOR + sav.info.file;
+		index[sav.info.file] = sav;
+	    }
+	}
+    }
+
+    void WriteSAVIndex(const std::string & dir, const SAVInfoList & saves)
+    {
+	const std::string idxname = dir + SEPARATOR + "saves.idx";
+	std::ofstream os(idxname.c_str(), std::ios::binary);
+
+	if(os.is_open())
+	{
+	    StreamBuf sb(saves.size() * (THUMBNAILSIZE * THUMBNAILSIZE + 512));
+
+	    sb << SAVIDXID << static_cast<u16>(CURRENT_FORMAT_VERSION) << static_cast<u32>(saves.size());
+
+	    for(SAVInfoList::const_iterator
+		it = saves.begin(); it != saves.end(); ++it)
+		sb << *it;
+
+	    os << sb;
+	}
+    }
+
+    /* the saves dir index: one file written again */
+    void UpdateSAVIndex(const std::string & fn)
+    {
+	const std::string dir = GetDirname(fn);
+	const std::string file = dir + SEPARATOR + GetBasename(fn);
+	std::map<std::string, SAVInfo> index;
+	SAVInfo sav;
+
+	ReadSAVIndex(dir, index);
+
+	if(ReadSAVInfo(file, sav))
+	    index[file] = sav;
+	else
+	    index.erase(file);
+
+	SAVInfoList saves;
+	saves.reserve(index.size());
+
+	for(std::map<std::string, SAVInfo>::const_iterator
+	    it = index.begin(); it != index.end(); ++it)
+	    saves.push_back((*it).second);
+
+	WriteSAVIndex(dir, saves);
+    }
+
+    bool SaveAutosave(const std::string &);
+    bool LoadSAV2(std::istream &, const std::string &);
+    bool LoadSAV3(std::istream &, const std::string &);
+}
+
+void Game::SectionSAV::Encode(bool compress)
+{
+    rawsize = data.size();
+    checksum = CheckSum(data.data(), data.size());
+    flags = 0;
+
+#ifdef WITH_ZLIB
+    if(compress)
+    {
+	zdata << data;
+	if(! zdata.fail()) flags |= IS_COMPRESS;
+    }
+#endif
+}
+
+void Game::SectionSAV::Decode(void)
+{
+#ifdef WITH_ZLIB
+    if(flags & IS_COMPRESS)
+    {
+	if(zdata.fail())
+	{
+	    valid = false;
+	    return;
+	}
+
+	zdata >> data;
+    }
+#else
+    if(flags & IS_COMPRESS)
+    {
+	DEBUG(DBG_GAME, DBG_WARN, "zlib: unsupported");
+	valid = false;
+	return;
+    }
+#endif
+
+    valid = ! data.fail() && data.size() == rawsize &&
+		checksum == CheckSum(data.data(), data.size());
+}
+
+bool Game::Save(const std::string &fn)
+{
+    DEBUG(DBG_GAME, DBG_INFO, fn);
+    const bool autosave = (GetBasename(fn) == "autosave.sav");
+    const Settings & conf = Settings::Get();
+
+    // ask overwrite?
+    if(IsFile(fn) &&
+	((!autosave && conf.ExtGameRewriteConfirm()) || (autosave && Settings::Get().ExtGameAutosaveConfirm())) &&
+	Dialog::NO == Dialog::Message("", _("Are you sure you want to overwrite the save with this name?"), Font::BIG, Dialog::YES|Dialog::NO))
+    {
+	return false;
+    }
+
+    if(autosave && conf.ExtGameAutosaveDelta())
+	return SaveAutosave(fn);
+
+    SectionsSAV sections;
+    sections.reserve(SECTIONSMAX);
+
+    AddGameSections(sections);
+    AddSection(sections, SECTION_WORLD).data << World::Get();
+
+    if(! WriteSections(fn, sections))
+	return false;
+
+    if(! autosave) Game::SetLastSavename(fn);
+
+    return true;
+}
+
+/* autosave: the full base, then the tiles changed from the base with the last states */
+bool Game::SaveAutosave(const std::string & fn)
+{
+    AutosaveBase & base = GetAutosaveBase();
+    const s32 count = world.w() * world.h();
+    const u16 day = world.CountDay();
+    StreamBuf tile(256);
+    std::vector<u32> checksums(count, 0);
+    std::vector<u32> lengths(count, 0);
+    MapsIndexes changes;
+
+    for(s32 index = 0; index < count; ++index)
+    {
+	tile.reset();
+	tile << world.GetTiles(index);
+	checksums[index] = CheckSum(tile.data(), tile.size());
+	lengths[index] = tile.size();
+
+	if(static_cast<size_t>(index) < base.tiles.size() &&
+	    base.tiles[index] != checksums[index]) changes.push_back(index);
+    }
+
+    u32 id = 0;
+
+    // compaction: the new base every week, for many changes, or if the base file is other
+    const bool full = base.tiles.size() != static_cast<size_t>(count) ||
+	base.width != world.w() || base.height != world.h() ||
+	day < base.day || day >= base.day + DAYOFWEEK || changes.size() > static_cast<size_t>(count / 4) ||
+	! CheckAutosaveBase(fn, base.id);
+
+    SectionsSAV sections;
+    sections.reserve(SECTIONSMAX);
+
+    AddGameSections(sections);
+
+    if(full)
+    {
+	id = static_cast<u32>(std::time(NULL));
+	if(id == base.id) ++id;
+
+	AddSection(sections, SECTION_WORLD).data << World::Get();
+	AddSection(sections, SECTION_BASE).data << id << lengths;
+
+	if(! WriteSections(fn, sections))
+	    return false;
+
+	base.id = id;
+	base.day = day;
+	base.width = world.w();
+	base.height = world.h();
+	base.tiles.swap(checksums);
+
+	std::remove(GetDeltaName(fn).c_str());
+	DEBUG(DBG_GAME, DBG_INFO, "base: " << fn);
+    }
+    else
+    {
+	StreamBuf & data = AddSection(sections, SECTION_TILES).data;
+
+	data << base.id << static_cast<u32>(changes.size());
+
+	for(MapsIndexes::const_iterator
+	    it = changes.begin(); it != changes.end(); ++it)
+	{
+	    tile.reset();
+	    tile << world.GetTiles(*it);
+	    data << *it << std::vector<u8>(tile.data(), tile.data() + tile.size());
+	}
+
+	World::Get().SaveStates(AddSection(sections, SECTION_STATES).data);
+
+	if(! WriteSections(GetDeltaName(fn), sections))
+	    return false;
+
+	// the save mtime is not changed: the saves list entry with the new header
+	UpdateSAVIndex(fn);
+
+	DEBUG(DBG_GAME, DBG_INFO, "delta: " << GetDeltaName(fn) << ", tiles: " << changes.size());
+    }
+
+    return true;
+}
+
+bool Game::Load(const std::string & fn)
+{
+    DEBUG(DBG_GAME, DBG_INFO, fn);
+    bool result = false;
+    // loading info
+    Game::ShowLoadMapsText();
+
+    std::ifstream fs(fn.c_str(), std::ios::binary);
+
+    if(fs.is_open())
+    {
+	char major, minor;
+	fs >> std::noskipws >> major >> minor;
+	const u16 savid = (static_cast<u16>(major) << 8) | static_cast<u16>(minor);
+
+	// check version sav file
+	if(savid == SAV3ID)
+	    result = LoadSAV3(fs, fn);
+	else
+	if(savid == SAV2ID)
+	    result = LoadSAV2(fs, fn);
+    }
+
+    if(result)
+    {
+	Settings & conf = Settings::Get();
+	Game::SetLastSavename(fn);
+	conf.SetGameType(conf.GameType() | Game::TYPE_LOADFILE);
+    }
+
+    return result;
+}
+
+bool Game::LoadSAV3(std::istream & fs, const std::string & fn)
+{
+    SectionsSAV sections;
+
+    if(! ReadSectionsTOC(fs, sections))
+    {
+	DEBUG(DBG_GAME, DBG_INFO, fn << ", toc" << " read: error");
+	return false;
+    }
+
+    // the file reads in order, uncompress and checksum in parallel
+    for(SectionsSAV::iterator
+	it = sections.begin(); it != sections.end(); ++it)
+	if(! ReadSection(fs, *it))
+	{
+	    DEBUG(DBG_GAME, DBG_INFO, fn << ", section: " << SectionName((*it).tag) << " read: error");
+	    return false;
+	}
+
+    SectionsRun(sections, SectionDecode);
+
+    const u32 tags[] = { SECTION_HEADER, SECTION_WORLD, SECTION_SETTINGS,
+				SECTION_GAMEOVER, SECTION_STATIC, SECTION_MONSTERS };
+    SectionSAV* parts[ARRAY_COUNT(tags)];
+
+    // required sections, the others are optional
+    for(u8 ii = 0; ii < ARRAY_COUNT(tags); ++ii)
+    {
+	parts[ii] = FindSection(sections, tags[ii]);
+
+	if(! parts[ii] || ! parts[ii]->valid)
+	{
+	    DEBUG(DBG_GAME, DBG_WARN, fn << ", section: " << SectionName(tags[ii]) << (parts[ii] ? ", checksum: error" : ", not found"));
+	    return false;
+	}
+    }
+
+    SectionSAV* base = FindSection(sections, SECTION_BASE);
+    StreamBuf* world = &parts[1]->data;
+    StreamBuf replay(0);
+    SectionsSAV delta;
+
+    // autosave: the last delta from this base
+    if(base && base->valid && ReadSections(GetDeltaName(fn), delta))
+    {
+	if(ReplayDelta(*parts[1], *base, delta, replay))
+	{
+	    for(u8 ii = 0; ii < ARRAY_COUNT(tags); ++ii)
+		if(tags[ii] != SECTION_WORLD && FindSection(delta, tags[ii]))
+		    parts[ii] = FindSection(delta, tags[ii]);
+
+	    world = &replay;
+	    DEBUG(DBG_GAME, DBG_INFO, "delta: " << GetDeltaName(fn));
+	}
+	else
+	    DEBUG(DBG_GAME, DBG_WARN, "delta: " << GetDeltaName(fn) << ", skipped");
+    }
+
+    std::string strver;
+    u16 binver = 0;
+    HeaderSAV header;
+
+    parts[0]->data >> strver >> binver >> header;
+
+    if(! CheckHeaderSAV(header, binver))
+	return false;
+
+    SetLoadVersion(binver);
+
+    *world >> World::Get();
+    parts[2]->data >> Settings::Get();
+    parts[3]->data >> GameOver::Result::Get();
+    parts[4]->data >> GameStatic::Data::Get();
+    parts[5]->data >> MonsterStaticData::Get();
+
+    SetLoadVersion(CURRENT_FORMAT_VERSION);
+
+    for(u8 ii = 1; ii < ARRAY_COUNT(tags); ++ii)
+	if((tags[ii] == SECTION_WORLD ? world : &parts[ii]->data)->fail())
+    {
+	DEBUG(DBG_GAME, DBG_WARN, "invalid load file: " << fn << ", section: " << SectionName(tags[ii]));
+	return false;
+    }
+
+    return true;
+}
+
+/* legacy: one stream after the header */
+bool Game::LoadSAV2(std::istream & fs, const std::string & fn)
+{
+    const Settings & conf = Settings::Get();
+    std::string strver;
+    u16 binver = 0;
+    StreamBuf hinfo(1024);
+    StreamBuf gdata((Maps::MEDIUM < conf.MapsWidth() ? 1024 :512) * 1024);
+    HeaderSAV header;
+
+    fs >> hinfo;
+
+    if(hinfo.fail())
+    {
+	DEBUG(DBG_GAME, DBG_INFO, fn << ", hinfo" << " read: error");
+	return false;
+    }
+
+    hinfo >> strver >> binver >> header;
+
+#ifndef WITH_ZLIB
+    if(header.status & HeaderSAV::IS_COMPRESS)
+    {
+	DEBUG(DBG_GAME, DBG_INFO, fn << ", zlib: unsupported");
+	return false;
+    }
+    else
+#else
+    if(header.status & HeaderSAV::IS_COMPRESS)
+    {
+	ZStreamBuf zdata;
+	fs >> zdata;
+
+	if(zdata.fail())
+	{
+	    DEBUG(DBG_GAME, DBG_INFO, fn << ", zdata" << " read: error");
+	    return false;
+	}
+
+	zdata >> gdata;
+
+	if(gdata.fail())
+	{
+	    DEBUG(DBG_GAME, DBG_INFO, ", uncompress: error");
+	    return false;
+	}
+    }
+    else
+#endif
+    {
+	fs >> gdata;
+
+	if(gdata.fail())
+	{
+	    DEBUG(DBG_GAME, DBG_INFO, fn << ", gdata" << " read: error");
+	    return false;
+	}
+    }
+
+    gdata >> binver;
+
+    if(! CheckHeaderSAV(header, binver))
+	return false;
+
+    SetLoadVersion(binver);
+    u16 end_check = 0;
+
+    if(GetLoadVersion() < FORMAT_VERSION_2830)
+    {
+	gdata >> Settings::Get() >> World::Get() >> GameOver::Result::Get() >>
+	    GameStatic::Data::Get() >> MonsterStaticData::Get() >> end_check;
+    }
+    else
+    {
+	gdata >> World::Get() >> Settings::Get() >> GameOver::Result::Get() >>
+	    GameStatic::Data::Get() >> MonsterStaticData::Get() >> end_check;
+    }
+
+    if(end_check == SAV2ID)
+    {
+	SetLoadVersion(CURRENT_FORMAT_VERSION);
+	return true;
+    }
+
+    DEBUG(DBG_GAME, DBG_WARN, "invalid load file: " << fn);
+    return false;
+}
+
+/* SAV3: one section without the others */
+bool Game::LoadSAVSection(const std::string & fn, u32 tag, StreamBuf & data)
+{
+    std::ifstream fs(fn.c_str(), std::ios::binary);
+
+    if(fs.is_open())
+    {
+	char major, minor;
+	fs >> std::noskipws >> major >> minor;
+	const u16 savid = (static_cast<u16>(major) << 8) | static_cast<u16>(minor);
+	SectionsSAV sections;
+
+	if(savid == SAV3ID && ReadSectionsTOC(fs, sections))
+	{
+	    SectionSAV* section = FindSection(sections, tag);
+
+	    if(section && ReadSection(fs, *section))
+	    {
+		section->Decode();
+
+		if(section->valid)
+		{
+		    data = section->data;
+		    return true;
+		}
+	    }
+	}
+    }
+
+    return false;
+}
+
+bool Game::LoadSAV2FileInfo(const std::string & fn,  Maps::FileInfo & finfo)
+{
+    std::ifstream fs(fn.c_str(), std::ios::binary);
+
+    if(fs.is_open())
+    {
+	char major, minor;
+	fs >> std::noskipws >> major >> minor;
+	const u16 savid = (static_cast<u16>(major) << 8) | static_cast<u16>(minor);
+
+	HeaderSAV header;
+	StreamBuf hinfo(1024);
+	std::string strver;
+	u16 binver = 0;
+
+	// SAV3: the header section only
+	if(savid == SAV3ID)
+	{
+	    SectionsSAV sections;
+
+	    if(! ReadSectionsTOC(fs, sections))
+		return false;
+
+	    SectionSAV* section = FindSection(sections, SECTION_HEADER);
+
+	    if(! section || ! ReadSection(fs, *section))
+		return false;
+
+	    section->Decode();
+
+	    if(! section->valid)
+	    {
+		DEBUG(DBG_GAME, DBG_INFO, fn << ", header" << " read: error");
+		return false;
+	    }
+
+	    section->data >> strver >> binver >> header;
+
+#ifndef WITH_ZLIB
+	    // check: compress game data
+	    section = FindSection(sections, SECTION_WORLD);
+
+	    if(! section || (section->flags & SectionSAV::IS_COMPRESS))
+	    {
+		DEBUG(DBG_GAME, DBG_INFO, fn << ", zlib: unsupported");
+		return false;
+	    }
+#endif
+	}
+	else
+	// check version sav file
+	if(savid == SAV2ID)
+	{
+	    fs >> hinfo;
+
+	    if(hinfo.fail())
+	    {
+		DEBUG(DBG_GAME, DBG_INFO, fn << ", hinfo" << " read: error");
+		return false;
+	    }
+
+	    hinfo >> strver >> binver >> header;
+
+#ifndef WITH_ZLIB
+	    // check: compress game data
+	    if(header.status & HeaderSAV::IS_COMPRESS)
+	    {
+		DEBUG(DBG_GAME, DBG_INFO, fn << ", zlib: unsupported");
+		return false;
+	    }
+#endif
+	}
+	else
+	    return false;
+
+	// hide: unsupported version
+	if(binver > CURRENT_FORMAT_VERSION || binver < LAST_FORMAT_VERSION)
+	    return false;
+
+	finfo = header.info;
+	finfo.file = fn;
+
+	return true;
+    }
+
+    return false;
+}
+
+bool Game::LoadSAVThumbnail(const std::string & fn, std::vector<u8> & pixels)
+{
+    StreamBuf data(0);
+    u16 size = 0;
+
+    if(! LoadSAVSection(fn, SECTION_THUMBNAIL, data))
+	return false;
+
+    data >> size >> pixels;
+
+    if(data.fail() || pixels.size() != static_cast<size_t>(size * size))
+    {
+	pixels.clear();
+	return false;
+    }
+
+    return true;
+}
+
+bool Game::LoadSAVKingdoms(const std::string & fn, KingdomInfoList & kingdoms)
+{
+    StreamBuf data(0);
+
+    if(! LoadSAVSection(fn, SECTION_KINGDOMS, data))
+	return false;
+
+    data >> kingdoms;
+
+    if(data.fail() || kingdoms.size() > KINGDOMMAX)
+    {
+	kingdoms.clear();
+	return false;
+    }
+
+    return true;
+}
+
+/* the saves dir index: headers and thumbnails, the changed files only are read again */
+Game::SAVInfoList Game::GetSAVInfoList(const std::string & dir)
+{
+    std::map<std::string, SAVInfo> index;
+    SAVInfoList result;
+    bool changed = false;
+
+    ReadSAVIndex(dir, index);
+
+    ListFiles files;
+    files.ReadDir(dir, ".sav", false);
+
+    for(ListFiles::const_iterator
+	it = files.begin(); it != files.end(); ++it)
+    {
+	u32 mtime = 0;
+	u32 size = 0;
+	if(! StatSAV(*it, mtime, size)) continue;
+
+	std::map<std::string, SAVInfo>::const_iterator itsav = index.find(*it);
+
+	if(itsav != index.end() &&
+	    (*itsav).second.mtime == mtime && (*itsav).second.size == size)
+	{
+	    result.push_back((*itsav).second);
+	    continue;
+	}
+
+	SAVInfo sav;
+	changed = true;
+
+	if(ReadSAVInfo(*it, sav))
+	    result.push_back(sav);
+    }
+
+    // removed files
+    if(index.size() != result.size())
+	changed = true;
+
+    if(changed)
+	WriteSAVIndex(dir, result);
+
+    return result;
+}
+
+/* the world key: the maps file and the game setup (players, difficulty, world options) */
+u32 Game::MapsCacheKey(const std::string & fn)
+{
+    std::ifstream fs(fn.c_str(), std::ios::binary);
+
+    if(! fs.is_open())
+	return 0;
+
+    std::vector<char> mp2((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+
+    if(mp2.empty())
+	return 0;
+
+    StreamBuf sb(1024);
+    sb << CheckSum(&mp2[0], mp2.size());
+    Settings::Get().WriteMapsSetup(sb);
+
+    const u32 key = CheckSum(sb.data(), sb.size());
+    return key ? key : 1;
+}
+
+bool Game::SaveMapsCache(const std::string & fn, u32 key)
+{
+    const std::string cache = GetMapsCacheName(fn);
+    SectionsSAV sections;
+    sections.reserve(2);
+
+    if(cache.empty())
+	return false;
+
+    const Players & players = Settings::Get().GetPlayers();
+    SectionSAV & mkey = AddSection(sections, SECTION_MAPSKEY);
+
+    mkey.data << key << static_cast<u16>(CURRENT_FORMAT_VERSION) << GameStatic::uniq <<
+	static_cast<u32>(players.size());
+
+    // the random races roll goes with the world
+    for(Players::const_iterator
+	it = players.begin(); it != players.end(); ++it)
+	mkey.data << (*it)->color << (*it)->race;
+
+    AddSection(sections, SECTION_WORLD).data << World::Get();
+
+    return WriteSections(cache, sections);
+}
+
+/* the world as after World::ReadMaps, false: parse the maps */
+bool Game::LoadMapsCache(const std::string & fn, u32 key)
+{
+    const std::string cache = GetMapsCacheName(fn);
+    SectionsSAV sections;
+
+    if(cache.empty() || ! CheckMapsCache(cache, key) || ! ReadSections(cache, sections))
+	return false;
+
+    SectionSAV* mkey = FindSection(sections, SECTION_MAPSKEY);
+    SectionSAV* world = FindSection(sections, SECTION_WORLD);
+    u32 cachekey = 0;
+    u16 binver = 0;
+    u32 uniq = 0;
+    u32 count = 0;
+    std::vector<std::pair<u8, u8> > races;
+
+    if(! mkey || ! world)
+	return false;
+
+    mkey->data >> cachekey >> binver >> uniq >> count;
+
+    for(u32 ii = 0; ii < count && ii <= KINGDOMMAX && ! mkey->data.fail(); ++ii)
+    {
+	std::pair<u8, u8> race;
+	mkey->data >> race.first >> race.second;
+	races.push_back(race);
+    }
+
+    if(mkey->data.fail() || races.size() != count || cachekey != key || binver != CURRENT_FORMAT_VERSION)
+	return false;
+
+    SetLoadVersion(CURRENT_FORMAT_VERSION);
+    world->data >> World::Get();
+
+    if(world->data.fail())
+    {
+	DEBUG(DBG_GAME, DBG_WARN, "invalid maps cache: " << cache);
+	return false;
+    }
+
+    GameStatic::uniq = uniq;
+
+    for(std::vector<std::pair<u8, u8> >::const_iterator
+	it = races.begin(); it != races.end(); ++it)
+	Players::SetPlayerRace((*it).first, (*it).second);
+
+    return true;
+}
+
+/* headless: the maps cache for the default setup of the maps in dir */
+bool Game::PrewarmMapsCache(const std::string & dir)
+{
+    Settings & conf = Settings::Get();
+    ListFiles maps;
+    u32 count = 0;
+
+    maps.ReadDir(dir, ".mp2", false);
+    maps.ReadDir(dir, ".mx2", false);
+
+    if(maps.empty())
+    {
+	DEBUG(DBG_GAME, DBG_WARN, "maps not found: " << dir);
+	return false;
+    }
+
+    if(IS_DEVEL())
+    {
+	DEBUG(DBG_GAME, DBG_WARN, "devel debug: the debug hero is not cached");
+	return false;
+    }
+
+    conf.SetGameType(Game::TYPE_STANDARD);
+
+    for(ListFiles::const_iterator
+	it = maps.begin(); it != maps.end(); ++it)
+    {
+	Maps::FileInfo fi;
+
+	if(! fi.ReadMP2(*it))
+	{
+	    DEBUG(DBG_GAME, DBG_WARN, "incorrect maps: " << *it);
+	    continue;
+	}
+
+	conf.SetCurrentFileInfo(fi);
+	conf.GetPlayers().SetStartGame();
+
+	const u32 key = MapsCacheKey(*it);
+
+	if(! key)
+	    continue;
+
+	// up to date
+	if(CheckMapsCache(GetMapsCacheName(*it), key))
+	{
+	    ++count;
+	    continue;
+	}
+
+	if(World::Get().ReadMaps(*it) && SaveMapsCache(*it, key))
+	{
+	    VERBOSE("maps cache: " << *it);
+	    ++count;
+	}
+	else
+	    DEBUG(DBG_GAME, DBG_WARN, "maps cache: " << *it << ", skipped");
+    }
+
+    VERBOSE("maps cache: " << count << " of " << maps.size());
+
+    return count == maps.size();
+}
@@ -23,15 +23,73 @@
 #ifndef H2GAMEIO_H
 #define H2GAMEIO_H
 
+#include <vector>
 #include "game.h"
+#include "maps_fileinfo.h"
 
-namespace Maps { class FileInfo; }
+class StreamBuf;
 
 namespace Game
 {
+    // SAV3 sections
+    enum
+    {
+	SECTION_HEADER		= 0x48454144,	// HEAD
+	SECTION_WORLD		= 0x57524C44,	// WRLD
+	SECTION_SETTINGS	= 0x434F4E46,	// CONF
+	SECTION_GAMEOVER	= 0x4F564552,	// OVER
+	SECTION_STATIC		= 0x53544154,	// STAT
+	SECTION_MONSTERS	= 0x4D4F4E53,	// MONS
+	SECTION_THUMBNAIL	= 0x5448554D,	// THUM
+	SECTION_KINGDOMS	= 0x4B494E47,	// KING: kingdoms summary
+	SECTION_BASE		= 0x42415345,	// BASE: autosave base, tiles lengths
+	SECTION_TILES		= 0x54494C45,	// TILE: autosave delta, changed tiles
+	SECTION_STATES		= 0x57535441,	// WSTA: autosave delta, world without tiles
+	SECTION_MAPSKEY		= 0x4D4B4559	// MKEY: maps cache, world key and version
+    };
+
+    enum { THUMBNAILSIZE = 64 };
+
+    // the saves list item: see Game::GetSAVInfoList
+    struct SAVInfo
+    {
+	SAVInfo() : mtime(0), size(0) {}
+
+	Maps::FileInfo	info;
+	u32		mtime;
+	u32		size;
+	std::vector<u8>	thumbnail;	// palette indexes, THUMBNAILSIZE x THUMBNAILSIZE
+    };
+
+    typedef std::vector<SAVInfo> SAVInfoList;
+
+    // the kingdom summary: see Game::LoadSAVKingdoms
+    struct KingdomInfo
+    {
+	KingdomInfo() : color(0), control(0), race(0), heroes(0), castles(0), gold(0) {}
+
+	u8		color;
+	u8		control;
+	u8		race;
+	u16		heroes;
+	u16		castles;
+	s32		gold;
+    };
+
+    typedef std::vector<KingdomInfo> KingdomInfoList;
+
     bool Save(const std::string &);
     bool Load(const std::string &);
     bool LoadSAV2FileInfo(const std::string &,  Maps::FileInfo &);
+    bool LoadSAVSection(const std::string &, u32 tag, StreamBuf &);
+    bool LoadSAVThumbnail(const std::string &, std::vector<u8> &);
+    bool LoadSAVKingdoms(const std::string &, KingdomInfoList &);
+    SAVInfoList GetSAVInfoList(const std::string & dir);
+
+    u32  MapsCacheKey(const std::string &);
+    bool SaveMapsCache(const std::string &, u32 key);
+    bool LoadMapsCache(const std::string &, u32 key);
+    bool PrewarmMapsCache(const std::string & dir);
 }
 
 #endif
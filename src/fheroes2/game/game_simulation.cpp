@@ -0,0 +1,362 @@
+/***************************************************************************
+ *   Copyright (C) 2012 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+
+#include "settings.h"
+#include "world.h"
+#include "kingdom.h"
+#include "heroes.h"
+#include "castle.h"
+#include "army.h"
+#include "artifact.h"
+#include "skill.h"
+#include "spell.h"
+#include "race.h"
+#include "battle.h"
+#include "game.h"
+
+#define SIMULATION_MAPSIZE 16
+
+/*
+ batch file: one matchup per line, "attacker | defender | options"
+ attacker, defender (tokens):
+    hero:<id> attack:<n> defense:<n> power:<n> knowledge:<n>
+    skill:<id>:<level> art:<id> spell:<id> troop:<monster>:<count>
+ options:
+    siege		defender in castle (with moat and turrets)
+    repeat:<n>		run matchup n times
+ example:
+    hero:1 attack:2 skill:3:2 troop:11:20 troop:15:10 | troop:32:30 | repeat:100
+*/
+
+namespace Game
+{
+    void LoadExternalResource(const Settings &);
+
+    struct SimulationSide
+    {
+	SimulationSide() : hero(-1), attack(0), defense(0), power(0), knowledge(0) {}
+
+	s32				hero;
+	u8				attack;
+	u8				defense;
+	u8				power;
+	u8				knowledge;
+	std::vector<Skill::Secondary>	skills;
+	std::vector<Artifact>		artifacts;
+	std::vector<Spell>		spells;
+	std::vector<Troop>		troops;
+    };
+
+    struct SimulationMatchup
+    {
+	SimulationMatchup() : line(0), siege(false), repeat(1) {}
+
+	u32		line;
+	SimulationSide	side1;
+	SimulationSide	side2;
+	bool		siege;
+	u32		repeat;
+    };
+
+    bool ParseSimulationSide(const std::string &, SimulationSide &);
+    bool ParseSimulationMatchup(const std::string &, SimulationMatchup &);
+    Heroes* PrepareSimulationHero(const SimulationSide &, u8 color, const Point &);
+    void PrepareSimulationArmy(const SimulationSide &, Army &);
+    Castle* PrepareSimulationCastle(u8 color, u8 race, const Point &);
+    void RunSimulationMatchup(const SimulationMatchup &, u32 run, std::ostream &);
+}
+
+std::vector<std::string> SplitSimulationString(const std::string & str, char sep)
+{
+    std::vector<std::string> res;
+    std::istringstream is(str);
+    std::string token;
+
+    while(std::getline(is, token, sep))
+	res.push_back(String::Trim(token));
+
+    return res;
+}
+
+bool Game::ParseSimulationSide(const std::string & str, SimulationSide & side)
+{
+    std::istringstream is(str);
+    std::string token;
+
+    while(is >> token)
+    {
+	const std::vector<std::string> param = SplitSimulationString(token, ':');
+	const std::string & key = param.front();
+	const int val1 = 1 < param.size() ? String::ToInt(param[1]) : 0;
+	const int val2 = 2 < param.size() ? String::ToInt(param[2]) : 0;
+
+	if(key == "hero")	side.hero = val1;
+	else
+	if(key == "attack")	side.attack = val1;
+	else
+	if(key == "defense")	side.defense = val1;
+	else
+	if(key == "power")	side.power = val1;
+	else
+	if(key == "knowledge")	side.knowledge = val1;
+	else
+	if(key == "skill")	side.skills.push_back(Skill::Secondary(val1, val2));
+	else
+	if(key == "art")	side.artifacts.push_back(Artifact(val1));
+	else
+	if(key == "spell")	side.spells.push_back(Spell(val1));
+	else
+	if(key == "troop")	side.troops.push_back(Troop(Monster(val1), val2));
+	else
+	{
+	    DEBUG(DBG_GAME, DBG_WARN, "unknown token: " << token);
+	    return false;
+	}
+    }
+
+    return side.troops.size();
+}
+
+bool Game::ParseSimulationMatchup(const std::string & str, SimulationMatchup & matchup)
+{
+    const std::vector<std::string> fields = SplitSimulationString(str, '|');
+
+    if(2 > fields.size() ||
+	! ParseSimulationSide(fields[0], matchup.side1) ||
+	! ParseSimulationSide(fields[1], matchup.side2)) return false;
+
+    if(2 < fields.size())
+    {
+	std::istringstream is(fields[2]);
+	std::string token;
+
+	while(is >> token)
+	{
+	    const std::vector<std::string> param = SplitSimulationString(token, ':');
+
+	    if(param.front() == "siege")
+		matchup.siege = true;
+	    else
+	    if(param.front() == "repeat" && 1 < param.size())
+		matchup.repeat = String::ToInt(param[1]);
+	    else
+	    {
+		DEBUG(DBG_GAME, DBG_WARN, "unknown option: " << token);
+		return false;
+	    }
+	}
+    }
+
+    // siege: the catapult needs commander
+    return ! matchup.siege || 0 <= matchup.side1.hero;
+}
+
+void Game::PrepareSimulationArmy(const SimulationSide & side, Army & army)
+{
+    army.Clean();
+
+    for(std::vector<Troop>::const_iterator
+	it = side.troops.begin(); it != side.troops.end(); ++it)
+	army.JoinTroop(*it);
+}
+
+Heroes* Game::PrepareSimulationHero(const SimulationSide & side, u8 color, const Point & center)
+{
+    Heroes* hero = 0 <= side.hero ? world.GetHeroes(Heroes::ConvertID(side.hero)) : NULL;
+
+    if(! hero || ! hero->Recruit(color, center)) return NULL;
+
+    for(u8 ii = 0; ii < side.attack; ++ii) hero->IncreasePrimarySkill(Skill::Primary::ATTACK);
+    for(u8 ii = 0; ii < side.defense; ++ii) hero->IncreasePrimarySkill(Skill::Primary::DEFENSE);
+    for(u8 ii = 0; ii < side.power; ++ii) hero->IncreasePrimarySkill(Skill::Primary::POWER);
+    for(u8 ii = 0; ii < side.knowledge; ++ii) hero->IncreasePrimarySkill(Skill::Primary::KNOWLEDGE);
+
+    for(std::vector<Skill::Secondary>::const_iterator
+	it = side.skills.begin(); it != side.skills.end(); ++it)
+	hero->LearnSkill(*it);
+
+    for(std::vector<Artifact>::const_iterator
+	it = side.artifacts.begin(); it != side.artifacts.end(); ++it)
+	hero->PickupArtifact(*it);
+
+    if(side.spells.size())
+    {
+	hero->SpellBookActivate();
+
+	for(std::vector<Spell>::const_iterator
+	    it = side.spells.begin(); it != side.spells.end(); ++it)
+	    hero->AppendSpellToBook(*it, true);
+    }
+
+    hero->SetSpellPoints(hero->GetMaxSpellPoints());
+    PrepareSimulationArmy(side, hero->GetArmy());
+
+    return hero;
+}
+
+Castle* Game::PrepareSimulationCastle(u8 color, u8 race, const Point & center)
+{
+    Kingdom & kingdom = world.GetKingdom(color);
+    Castle* castle = new Castle(center.x, center.y, race);
+
+    world.AddCastle(castle);
+    castle->ChangeColor(Color::Get(color));
+    kingdom.AddCastle(castle);
+    kingdom.AddFundsResource(Funds(100, 100, 100, 100, 100, 100, 100000));
+
+    const u32 builds[] = { BUILD_CASTLE, BUILD_MOAT, BUILD_LEFTTURRET, BUILD_RIGHTTURRET };
+
+    castle->SetModes(Castle::ALLOWCASTLE);
+
+    for(u8 ii = 0; ii < ARRAY_COUNT(builds); ++ii)
+    {
+	castle->SetModes(Castle::ALLOWBUILD);
+	castle->BuyBuilding(builds[ii]);
+    }
+
+    return castle;
+}
+
+void Game::RunSimulationMatchup(const SimulationMatchup & matchup, u32 run, std::ostream & csv)
+{
+    Settings & conf = Settings::Get();
+    Players & players = conf.GetPlayers();
+
+    const u8 color1 = Color::BLUE;
+    const u8 color2 = Color::RED;
+
+    world.NewMaps(SIMULATION_MAPSIZE, SIMULATION_MAPSIZE);
+
+    players.Init(color1 | color2);
+    players.SetPlayerControl(color1, CONTROL_AI);
+    players.SetPlayerControl(color2, CONTROL_AI);
+    world.GetKingdoms().Init();
+    conf.SetCurrentColor(color1);
+
+    // defender (or castle entrance) and attacker below
+    const Point center2(SIMULATION_MAPSIZE / 2, SIMULATION_MAPSIZE / 2);
+    const Point center1(center2.x, center2.y + 1);
+
+    Heroes* hero1 = PrepareSimulationHero(matchup.side1, color1, center1);
+    Heroes* hero2 = PrepareSimulationHero(matchup.side2, color2, center2);
+
+    Army monsters1, monsters2;
+    Army & army1 = hero1 ? hero1->GetArmy() : monsters1;
+    Army & army2 = hero2 ? hero2->GetArmy() : monsters2;
+
+    if(! hero1) PrepareSimulationArmy(matchup.side1, army1);
+    if(! hero2) PrepareSimulationArmy(matchup.side2, army2);
+
+    const Castle* castle = matchup.siege ?
+	PrepareSimulationCastle(color2, hero2 ? hero2->GetRace() : static_cast<u8>(Race::KNGT), center2) : NULL;
+
+    const u32 strength1 = army1.GetStrength();
+    const u32 strength2 = army2.GetStrength();
+
+    SDL::Time time;
+    time.Start();
+
+    const Battle::Result result = Battle::Loader(army1, army2, castle ? castle->GetIndex() : Maps::GetIndexFromAbsPoint(center2));
+
+    time.Stop();
+
+    csv << matchup.line << "," << run << "," << (castle ? 1 : 0) << "," <<
+	static_cast<int>(result.AttackerResult()) << "," << static_cast<int>(result.DefenderResult()) << "," <<
+	(result.AttackerWins() ? 1 : (result.DefenderWins() ? 2 : 0)) << "," <<
+	strength1 << "," << strength2 << "," <<
+	(result.AttackerWins() ? army1.GetStrength() : 0) << "," <<
+	(result.DefenderWins() ? army2.GetStrength() : 0) << "," <<
+	result.GetExperienceAttacker() << "," << result.GetExperienceDefender() << "," <<
+	result.killed << "," << time.Get() << std::endl;
+}
+
+bool Game::BattleSimulation(const std::string & batch, const std::string & output)
+{
+    std::ifstream fs(batch.c_str());
+
+    if(! fs.is_open())
+    {
+	DEBUG(DBG_GAME, DBG_WARN, "file not found: " << batch);
+	return false;
+    }
+
+    std::ofstream fcsv;
+    if(output.size()) fcsv.open(output.c_str());
+
+    if(output.size() && ! fcsv.is_open())
+	DEBUG(DBG_GAME, DBG_WARN, "write to stdout, can not open: " << output);
+
+    return BattleSimulation(fs, fcsv.is_open() ? fcsv : std::cout);
+}
+
+bool Game::BattleSimulation(std::istream & batch, std::ostream & csv)
+{
+    std::vector<SimulationMatchup> matchups;
+    std::string line;
+    u32 lineno = 0;
+
+    while(std::getline(batch, line))
+    {
+	++lineno;
+	line = String::Trim(line);
+	if(line.empty() || '#' == line[0]) continue;
+
+	SimulationMatchup matchup;
+	matchup.line = lineno;
+
+	if(ParseSimulationMatchup(line, matchup))
+	    matchups.push_back(matchup);
+	else
+	    DEBUG(DBG_GAME, DBG_WARN, "line " << lineno << ": incorrect matchup");
+    }
+
+    Settings & conf = Settings::Get();
+    conf.SetGameType(Game::TYPE_BATTLEONLY);
+
+    // monsters, spells and artifacts stats
+    if(conf.UseAltResource()) LoadExternalResource(conf);
+
+    csv << "line,run,siege,result1,result2,winner,strength1,strength2,"
+	"remain1,remain2,exp1,exp2,killed,time_ms" << std::endl;
+
+    SDL::Time total;
+    total.Start();
+    u32 battles = 0;
+
+    for(std::vector<SimulationMatchup>::const_iterator
+	it = matchups.begin(); it != matchups.end(); ++it)
+	for(u32 run = 0; run < (*it).repeat; ++run)
+    {
+	RunSimulationMatchup(*it, run, csv);
+	++battles;
+    }
+
+    total.Stop();
+    VERBOSE("battle simulation: " << battles << " battles, " << total.Get() << " ms");
+
+    return matchups.size();
+}
@@ -28,6 +28,7 @@
 #endif
 
 #include "ai.h"
+#include "ai_profile.h"
 #include "agg.h"
 #include "engine.h"
 #include "button.h"
@@ -195,6 +196,9 @@ Game::menu_t Game::StartGame(void)
     {
 	if(!skip_turns) world.NewDay();
 
+	// AI: plan all kingdoms from the day start
+	::AI::KingdomsPlan();
+
 	for(Players::const_iterator
 	    it = players.begin(); it != players.end(); ++it) if(*it)
 	{
@@ -264,6 +268,10 @@ Game::menu_t Game::StartGame(void)
 	DELAY(10);
     }
 
+    // AI: turns profile of the game
+    AI_PROFILE_SAVE(Settings::GetSaveDir() + SEPARATOR + "ai_profile.json");
+    AI_PROFILE_SAVE(Settings::GetSaveDir() + SEPARATOR + "ai_profile.csv");
+
     if(m == ENDTURN)
 	display.Fill(0, 0, 0);
     else
@@ -680,10 +688,15 @@ void Game::ShowPathOrStartMoveHero(Heroes* hero, const s32 dst_index)
     {
         hero->ResetModes(Heroes::SLEEPER);
         hero->SetMove(false);
-	path.Calculate(dst_index);
-        DEBUG(DBG_GAME, DBG_TRACE, hero->GetName() << ", route: " << path.String());
+	// long route: calculated in background, see HumanTurn
+	if(path.RequestAsync(dst_index))
+	    cursor.SetThemes(Cursor::WAIT);
+	else
+	{
+    	    DEBUG(DBG_GAME, DBG_TRACE, hero->GetName() << ", route: " << path.String());
+	    cursor.SetThemes(Game::GetCursor(dst_index));
+	}
 	I.SetRedraw(REDRAW_GAMEAREA);
-	cursor.SetThemes(Game::GetCursor(dst_index));
     }
     // start move
     else
@@ -993,6 +1006,18 @@ Game::menu_t Game::HumanTurn(bool isload)
 	    continue;
         }
 
+	// background route calculation
+	if(GameFocus::GetHeroes() &&
+	    GameFocus::GetHeroes()->GetPath().UpdateAsync())
+	{
+	    I.SetRedraw(REDRAW_GAMEAREA);
+	    I.gameArea.SetUpdateCursor();
+	}
+
+	// background route progress: the status window hourglass
+	I.statusWindow.SetRouteProgress(GameFocus::GetHeroes() ?
+		GameFocus::GetHeroes()->GetPath().GetProgress() : 100);
+
 	// heroes move animation
         if(AnimateInfrequent(CURRENT_HERO_DELAY))
         {
@@ -1052,6 +1077,8 @@ Game::menu_t Game::HumanTurn(bool isload)
 	}
     }
 
+    Route::Path::StopAsync();
+
     if(ENDTURN == res)
     {
 	// warning lost all town
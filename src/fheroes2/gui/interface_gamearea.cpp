@@ -257,14 +257,15 @@ void Interface::GameArea::Redraw(Surface & dst, u8 flag, const Rect & rt) const
     if(flag & LEVEL_FOG)
     {
 	const u8 colors = Players::FriendColors();
+	const Maps::FogPlanes & fog = world.GetFog();
 
 	for(s16 oy = rt.y; oy < rt.y + rt.h; ++oy)
 	    for(s16 ox = rt.x; ox < rt.x + rt.w; ++ox)
 	{
-	    const Maps::Tiles & tile = world.GetTiles(rectMaps.x + ox, rectMaps.y + oy);
+	    const s32 index = Maps::GetIndexFromAbsPoint(rectMaps.x + ox, rectMaps.y + oy);
 
-	    if(tile.isFog(colors))
-		tile.RedrawFogs(dst, colors);
+	    if(fog.isFog(index, colors))
+		world.GetTiles(index).RedrawFogs(dst, colors);
 	}
     }
 }
@@ -51,6 +51,7 @@
 #define COLOR_GRAY	0x10
 
 u32 GetPaletteIndexFromGround(const u16 ground);
+u32 GetPaletteIndexFromColor(const u8 color);
 
 /* constructor */
 Interface::Radar::Radar() : spriteArea(NULL), spriteCursor(NULL), cursorArea(NULL),
@@ -181,6 +182,68 @@ void Interface::Radar::Generate(void)
     }
 }
 
+/* small maps for the saves list: palette indexes, the fog is black */
+void Interface::Radar::GetThumbnail(std::vector<u8> & pixels, u16 size, u8 color)
+{
+    const u16 world_w = world.w();
+    const u16 world_h = world.h();
+    const Maps::FogPlanes & fog = world.GetFog();
+
+    pixels.assign(size * size, 0);
+
+    if(0 == world_w || 0 == world_h) return;
+
+    for(u16 yy = 0; yy < size; ++yy)
+	for(u16 xx = 0; xx < size; ++xx)
+    {
+	const s32 index = (yy * world_h / size) * world_w + xx * world_w / size;
+	const Maps::Tiles & tile = world.GetTiles(index);
+	u32 pixel = 0;
+
+	if(fog.isFog(index, color))
+	    continue;
+
+	switch(tile.GetObject())
+	{
+	    case MP2::OBJ_HEROES:
+	    {
+		const Heroes* hero = tile.GetHeroes();
+		if(hero) pixel = GetPaletteIndexFromColor(hero->GetColor());
+	    }
+	    break;
+
+	    case MP2::OBJ_CASTLE:
+	    case MP2::OBJN_CASTLE:
+	    {
+		const Castle* castle = world.GetCastle(index);
+		if(castle) pixel = GetPaletteIndexFromColor(castle->GetColor());
+	    }
+	    break;
+
+	    case MP2::OBJ_DRAGONCITY:
+	    case MP2::OBJ_LIGHTHOUSE:
+	    case MP2::OBJ_ALCHEMYLAB:
+	    case MP2::OBJ_MINES:
+	    case MP2::OBJ_SAWMILL:
+		pixel = GetPaletteIndexFromColor(tile.QuantityColor()); break;
+
+	    default: break;
+	}
+
+	if(0 == pixel)
+	{
+	    if(tile.isRoad())
+		pixel = COLOR_ROAD;
+	    else
+	    if(0 != (pixel = GetPaletteIndexFromGround(tile.GetGround())) &&
+		tile.GetObject() == MP2::OBJ_MOUNTS)
+		pixel += 2;
+	}
+
+	pixels[yy * size + xx] = pixel;
+    }
+}
+
 void Interface::Radar::SetHide(bool f)
 {
     hide = f;
@@ -221,12 +284,14 @@ void Interface::Radar::RedrawArea(const u8 color)
     cursorArea->Hide();
     spriteArea->Blit(x, y, display);
 
+    const Maps::FogPlanes & fog = world.GetFog();
+
     for(s32 index = 0; index < world_w * world_h; ++index)
     {
 	const Maps::Tiles & tile = world.GetTiles(index);
-	bool show_tile = ! tile.isFog(color);
+	bool show_tile = ! fog.isFog(index, color);
 #ifdef WITH_DEBUG
-	     show_tile = IS_DEVEL() || ! tile.isFog(color);
+	     show_tile = IS_DEVEL() || show_tile;
 #endif
 
 	if(! show_tile)
@@ -304,6 +369,22 @@ Surface* Interface::Radar::GetSurfaceFromColor(const u8 color)
     return NULL;
 }
 
+u32 GetPaletteIndexFromColor(const u8 color)
+{
+    switch(color)
+    {
+	case Color::BLUE:	return (COLOR_BLUE);
+	case Color::GREEN:	return (COLOR_GREEN);
+	case Color::RED:	return (COLOR_RED);
+	case Color::YELLOW:	return (COLOR_YELLOW);
+	case Color::ORANGE:	return (COLOR_ORANGE);
+	case Color::PURPLE:	return (COLOR_PURPLE);
+	default: break;
+    }
+
+    return (COLOR_GRAY);
+}
+
 u32 GetPaletteIndexFromGround(const u16 ground)
 {
     switch(ground)
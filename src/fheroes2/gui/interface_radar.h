@@ -23,6 +23,7 @@
 #ifndef H2INTERFACE_RADAR_H
 #define H2INTERFACE_RADAR_H
 
+#include <vector>
 #include "dialog.h"
 #include "gamedefs.h"
 
@@ -46,6 +47,8 @@ namespace Interface
 
 	void QueueEventProcessing(void);
 
+	static void GetThumbnail(std::vector<u8> &, u16 size, u8 color);
+
     private:
 	Surface *GetSurfaceFromColor(const u8);
 	Radar();
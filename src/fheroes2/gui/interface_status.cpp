@@ -38,7 +38,7 @@
 #define AITURN_REDRAW_EXPIRE 20
 #define RESOURCE_WINDOW_EXPIRE 2500
 
-Interface::StatusWindow::StatusWindow() : state(STATUS_UNKNOWN), oldState(STATUS_UNKNOWN)
+Interface::StatusWindow::StatusWindow() : state(STATUS_UNKNOWN), oldState(STATUS_UNKNOWN), turn_progress(0), route_progress(100)
 {
     const Sprite & ston = AGG::GetICN(Settings::Get().ExtGameEvilInterface() ? ICN::STONBAKE : ICN::STONBACK, 0);
     Rect::w = ston.w();
@@ -57,6 +57,7 @@ void Interface::StatusWindow::Reset(void)
     oldState = STATUS_UNKNOWN;
     lastResource = Resource::UNKNOWN;
     countLastResource = 0;
+    route_progress = 100;
     ResetTimer();
 }
 
@@ -126,6 +127,9 @@ void Interface::StatusWindow::Redraw(void)
     if(STATUS_AITURN == state)
 	DrawAITurns();
     else
+    if(route_progress < 100)
+	DrawRouteProgress();
+    else
     if(STATUS_UNKNOWN != state && h >= (ston.h() * 3 + 15))
     {
         DrawDayInfo();
@@ -438,6 +442,38 @@ void Interface::StatusWindow::QueueEventProcessing(void)
     if(le.MousePressRight(*this)) Dialog::Message(_("Status Window"), _("This window provides information on the status of your hero or kingdom, and shows the date. Left click here to cycle throungh these windows."), Font::BIG);
 }
 
+/* background route: the hourglass while the route is calculated */
+void Interface::StatusWindow::SetRouteProgress(u8 v)
+{
+    if(100 < v) v = 100;
+
+    // redraw only by the sand frame
+    if(v / 10 != route_progress / 10)
+	Interface::Basic::Get().SetRedraw(REDRAW_STATUS);
+
+    route_progress = v;
+}
+
+void Interface::StatusWindow::DrawRouteProgress(void) const
+{
+    const Sprite & glass = AGG::GetICN(ICN::HOURGLAS, 0);
+
+    u16 dst_x = x + (w - glass.w()) / 2;
+    u16 dst_y = y + (h - glass.h()) / 2;
+
+    glass.Blit(dst_x, dst_y);
+
+    const Sprite & sand = AGG::GetICN(ICN::HOURGLAS, 1 + route_progress / 10);
+
+    dst_x += (glass.w() - sand.w() - sand.x() - 1);
+    dst_y += sand.y() + 2;
+
+    sand.Blit(dst_x, dst_y);
+
+    Text text(GetString(route_progress) + "%", Font::SMALL);
+    text.Blit(x + (w - text.w()) / 2, y + h - text.h() - 4);
+}
+
 void Interface::StatusWindow::RedrawTurnProgress(u8 v)
 {
     turn_progress = v;
@@ -50,6 +50,7 @@ namespace Interface
 	void SetState(info_t info);
 	void SetResource(u8, u16);
 	void RedrawTurnProgress(u8);
+	void SetRouteProgress(u8);
 	void QueueEventProcessing(void);
 
 	static void ResetTimer(void);
@@ -63,6 +64,7 @@ namespace Interface
 	void DrawResourceInfo(const u8 oh = 0) const;
 	void DrawBackground(void) const;
 	void DrawAITurns(void) const;
+	void DrawRouteProgress(void) const;
 	static u32 ResetResourceStatus(u32, void *);
 	static u32 RedrawAIStatus(u32, void *);
 
@@ -75,6 +77,7 @@ namespace Interface
 	Dialog::FrameBorder border;
 
 	u8 turn_progress;
+	u8 route_progress;
     };
 }
 
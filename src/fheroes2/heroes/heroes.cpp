@@ -1552,6 +1552,22 @@ void Heroes::RecalculateMovePoints(void)
     if(0 <= move_point_scale) move_point = GetMaxMovePoints() * move_point_scale / 1000;
 }
 
+/* position with world heroes index update */
+void Heroes::SetCenter(const Point & pt)
+{
+    const s32 index = GetIndex();
+
+    Maps::Position::SetCenter(pt);
+
+    world.UpdateHeroesIndex(index);
+    world.UpdateHeroesIndex(GetIndex());
+}
+
+void Heroes::SetIndex(s32 index)
+{
+    SetCenter(Maps::isValidAbsIndex(index) ? Maps::GetPoint(index) : Point(-1, -1));
+}
+
 void Heroes::Move2Dest(const s32 & dst_index, bool skip_action /* false */)
 {
     if(dst_index != GetIndex())
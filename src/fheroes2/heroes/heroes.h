@@ -204,6 +204,8 @@ public:
 
     bool Move(bool fast = false);
     void Move2Dest(const s32 &, bool skip_action = false);
+    void SetCenter(const Point &);
+    void SetIndex(s32);
     bool isEnableMove(void) const;
     bool CanMove(void) const;
     void SetMove(bool f);
@@ -359,6 +359,9 @@ void RecruitMonsterFromTile(Heroes & hero, Maps::Tiles & tile, const std::string
 // action to next cell
 void Heroes::Action(const s32 dst_index)
 {
+    // quantity and owner of the object may change
+    AI::WorldObjectChanged(dst_index, Color::ALL);
+
     if(CONTROL_AI == GetKingdom().GetControl())
 	return AI::HeroesAction(*this, dst_index);
 
@@ -261,8 +261,72 @@ u8 HeroBase::HasArtifact(const Artifact & art) const
         (bag_artifacts.isPresentArtifact(art) ? 1 : 0);
 }
 
+HeroBase::DerivedStats::DerivedStats() : attack(0), defense(0), power(0),
+    knowledge(0), morale(0), luck(0), valid(false)
+{
+    std::fill(key, key + ARRAY_COUNT(key), 0);
+}
+
+void HeroBase::GetDerivedKey(u8* key) const
+{
+    const Settings & conf = Settings::Get();
+    const Castle* castle = inCastle();
+
+    for(u8 ii = 0; ii < HEROESMAXARTIFACT; ++ii)
+	key[ii] = ii < bag_artifacts.size() ? bag_artifacts[ii]() : static_cast<u8>(Artifact::UNKNOWN);
+
+    // see HeroBase::HasArtifact, ArtifactsModifiersResult
+    key[HEROESMAXARTIFACT] =
+	(Modes(Heroes::SHIPMASTER) ? 0x01 : 0) |
+	(conf.ExtWorldUseUniqueArtifactsML() ? 0x02 : 0) |
+	(conf.ExtWorldUseUniqueArtifactsRS() ? 0x04 : 0) |
+	(conf.ExtWorldUseUniqueArtifactsPS() ? 0x08 : 0) |
+	(conf.ExtWorldUseUniqueArtifactsSS() ? 0x10 : 0);
+
+    // see Castle modificators
+    key[HEROESMAXARTIFACT + 1] = castle ? castle->GetRace() : 0;
+    key[HEROESMAXARTIFACT + 2] = castle ?
+	(0x01 | (castle->isBuild(BUILD_TAVERN) ? 0x02 : 0) | (castle->isBuild(BUILD_SPEC) ? 0x04 : 0)) : 0;
+}
+
+const HeroBase::DerivedStats & HeroBase::GetDerivedStats(void) const
+{
+    u8 key[ARRAY_COUNT(derived.key)];
+    GetDerivedKey(key);
+
+    if(! derived.valid || ! std::equal(key, key + ARRAY_COUNT(key), derived.key))
+    {
+	const Castle* castle = inCastle();
+
+	derived.attack = ArtifactsModifiersAttack(*this, NULL);
+	derived.defense = ArtifactsModifiersDefense(*this, NULL);
+	derived.power = ArtifactsModifiersPower(*this, NULL);
+	derived.knowledge = ArtifactsModifiersKnowledge(*this, NULL);
+	derived.morale = ArtifactsModifiersMorale(*this, NULL);
+	derived.luck = ArtifactsModifiersLuck(*this, NULL);
+
+	if(castle)
+	{
+	    derived.attack += castle->GetAttackModificator(NULL);
+	    derived.defense += castle->GetDefenseModificator(NULL);
+	    derived.power += castle->GetPowerModificator(NULL);
+	    derived.knowledge += castle->GetKnowledgeModificator(NULL);
+	    derived.morale += castle->GetMoraleModificator(NULL);
+	    derived.luck += castle->GetLuckModificator(NULL);
+	}
+
+	std::copy(key, key + ARRAY_COUNT(key), derived.key);
+	derived.valid = true;
+    }
+
+    return derived;
+}
+
 s8 HeroBase::GetAttackModificator(std::string* strs) const
 {
+    // without description: cached
+    if(! strs) return GetDerivedStats().attack;
+
     s8 result = ArtifactsModifiersAttack(*this, strs);
 
     // check castle modificator
@@ -276,6 +340,9 @@ s8 HeroBase::GetAttackModificator(std::string* strs) const
 
 s8 HeroBase::GetDefenseModificator(std::string* strs) const
 {
+    // without description: cached
+    if(! strs) return GetDerivedStats().defense;
+
     s8 result = ArtifactsModifiersDefense(*this, strs);
 
     // check castle modificator
@@ -289,6 +356,9 @@ s8 HeroBase::GetDefenseModificator(std::string* strs) const
 
 s8 HeroBase::GetPowerModificator(std::string* strs) const
 {
+    // without description: cached
+    if(! strs) return GetDerivedStats().power;
+
     s8 result = ArtifactsModifiersPower(*this, strs);
 
     // check castle modificator
@@ -302,6 +372,9 @@ s8 HeroBase::GetPowerModificator(std::string* strs) const
 
 s8 HeroBase::GetKnowledgeModificator(std::string* strs) const
 {
+    // without description: cached
+    if(! strs) return GetDerivedStats().knowledge;
+
     s8 result = ArtifactsModifiersKnowledge(*this, strs);
 
     // check castle modificator
@@ -315,13 +388,20 @@ s8 HeroBase::GetKnowledgeModificator(std::string* strs) const
 
 s8 HeroBase::GetMoraleModificator(std::string* strs) const
 {
-    s8 result = ArtifactsModifiersMorale(*this, strs);
+    s8 result = 0;
 
-    // check castle modificator
-    const Castle* castle = inCastle();
+    if(strs)
+    {
+	result = ArtifactsModifiersMorale(*this, strs);
 
-    if(castle)
-	result += castle->GetMoraleModificator(strs);
+	// check castle modificator
+	const Castle* castle = inCastle();
+
+	if(castle)
+	    result += castle->GetMoraleModificator(strs);
+    }
+    else
+	result = GetDerivedStats().morale;
 
     // army modificator
     if(GetArmy().AllTroopsIsRace(Race::NECR))
@@ -337,13 +417,20 @@ s8 HeroBase::GetMoraleModificator(std::string* strs) const
 
 s8 HeroBase::GetLuckModificator(std::string* strs) const
 {
-    s8 result = ArtifactsModifiersLuck(*this, strs);
+    s8 result = 0;
 
-    // check castle modificator
-    const Castle* castle = inCastle();
+    if(strs)
+    {
+	result = ArtifactsModifiersLuck(*this, strs);
 
-    if(castle)
-	result += castle->GetLuckModificator(strs);
+	// check castle modificator
+	const Castle* castle = inCastle();
+
+	if(castle)
+	    result += castle->GetLuckModificator(strs);
+    }
+    else
+	result = GetDerivedStats().luck;
 
     // army modificator
     result += GetArmy().GetLuckModificator(strs);
@@ -477,6 +564,9 @@ StreamBase & operator>> (StreamBase & msg, HeroBase & hero)
 {
     Skill::Primary & base = hero;
 
+    // derived stats: transient
+    hero.derived.valid = false;
+
     return
 	// primary
 	msg >> base >>
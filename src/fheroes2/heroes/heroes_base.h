@@ -100,6 +100,26 @@ protected:
 
     SpellBook spell_book;
     BagArtifacts bag_artifacts;
+
+    // artifacts and castle modificators: recomputed after the sources changes, not saved
+    struct DerivedStats
+    {
+	DerivedStats();
+
+	u8 key[HEROESMAXARTIFACT + 3]; // artifacts, modes, castle
+	s8 attack;
+	s8 defense;
+	s8 power;
+	s8 knowledge;
+	s8 morale;
+	s8 luck;
+	bool valid;
+    };
+
+    const DerivedStats & GetDerivedStats(void) const;
+    void GetDerivedKey(u8*) const;
+
+    mutable DerivedStats derived;
 };
 
 struct HeroHasArtifact : public std::binary_function <const HeroBase*, Artifact, bool>
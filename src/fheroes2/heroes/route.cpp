@@ -29,6 +29,7 @@
 #include "game.h"
 #include "settings.h"
 #include "route.h"
+#include "ai_profile.h"
 
 s32 Route::Step::GetIndex(void) const
 {
@@ -51,6 +52,11 @@ Route::Path::Path(const Heroes & h)
 {
 }
 
+Route::Path::~Path()
+{
+    CancelAsync();
+}
+
 u16 Route::Path::GetFrontDirection(void) const
 {
     return empty() ?
@@ -95,21 +101,27 @@ s32 Route::Path::GetDestinedIndex(void) const
 /* return length path */
 bool Route::Path::Calculate(const s32 dst_index, const u16 limit)
 {
+    AI_PROFILE(PATH);
+    CancelAsync();
     dst = dst_index;
 
-    if(Find(dst_index, limit))
-    {
-	// check monster dst
-	if(Maps::isValidAbsIndex(dst_index) &&
-	    MP2::OBJ_MONSTER == world.GetTiles(dst_index).GetObject())
-	    pop_back();
-    }
+    if(FindHierarchy(dst_index, limit) || Find(dst_index, limit))
+	FixMonsterDestination();
 
     return !empty();
 }
 
+void Route::Path::FixMonsterDestination(void)
+{
+    // check monster dst
+    if(!empty() && Maps::isValidAbsIndex(dst) &&
+	MP2::OBJ_MONSTER == world.GetTiles(dst).GetObject())
+	pop_back();
+}
+
 void Route::Path::Reset(void)
 {
+    CancelAsync();
     dst = hero.GetIndex();
     if(!empty())
     {
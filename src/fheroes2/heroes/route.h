@@ -23,8 +23,10 @@
 #define H2HEROPATH_H
 
 #include <list>
+#include <vector>
 #include "gamedefs.h"
 #include "direction.h"
+#include "route_hierarchy.h"
 
 class Heroes;
 
@@ -48,6 +50,7 @@ namespace Route
     {
 	public:
 	    Path(const Heroes & h);
+	    ~Path();
 
 	    s32		GetDestinationIndex(void) const;
 	    s32		GetLastIndex(void) const;
@@ -57,6 +60,15 @@ namespace Route
 	    u32		GetTotalPenalty(void) const;
 	    bool	Calculate(const s32 dst_index, const u16 limit = MAXU16);
 
+	    /* background calculation: only one request in progress */
+	    bool	RequestAsync(const s32 dst_index, const u16 limit = MAXU16);
+	    bool	UpdateAsync(void);
+	    void	CancelAsync(void);
+	    bool	isPending(void) const;
+	    u8		GetProgress(void) const;
+
+	    static void	StopAsync(void);
+
 	    void	Show(void){ hide = false; }
 	    void	Hide(void){ hide = true; }
 	    void	Reset(void);
@@ -77,7 +89,9 @@ namespace Route
     	    static u16	GetIndexSprite(u16 from, u16 to, u8 mod);
 
 	private:
-	    bool	Find(const s32 &, const u16 limit = MAXU16);
+	    bool	Find(const s32 &, const u16 limit = MAXU16, const Corridor* = NULL);
+	    bool	FindHierarchy(const s32 &, const u16 limit);
+	    void	FixMonsterDestination(void);
 
 	    friend StreamBase & operator<< (StreamBase &, const Path &);
 	    friend StreamBase & operator>> (StreamBase &, Path &);
@@ -87,6 +101,32 @@ namespace Route
 	    bool	hide;
     };
 
+    /* movement cost from the hero to the tiles around, the same passable rules as Path */
+    class DistanceField
+    {
+	public:
+	    DistanceField();
+
+	    void	Calculate(const Heroes &, const u16 limit);
+	    bool	isValid(const Heroes &) const;
+	    bool	isComplete(void) const;
+	    bool	isReachable(const s32 &) const;
+	    bool	isAffected(const s32 &) const;
+	    u16		Get(const s32 &) const;
+
+	private:
+	    void	Set(const s32 &, u32 cost, bool transit);
+
+	    std::vector<u16>	costs;		// as target, MAXU16: unreachable
+	    std::vector<u16>	transits;	// as transit
+	    std::vector<s32>	touched;
+	    std::vector< std::pair<u32, s32> > opened;
+	    const Heroes*	hero;
+	    s32			from;
+	    u16			day;
+	    bool		complete;
+    };
+
     StreamBase & operator<< (StreamBase &, const Step &);
     StreamBase & operator<< (StreamBase &, const Path &);
     StreamBase & operator>> (StreamBase &, Step &);
@@ -0,0 +1,466 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <set>
+#include <algorithm>
+#include "world.h"
+#include "heroes.h"
+#include "direction.h"
+#include "settings.h"
+#include "route_hierarchy.h"
+
+#define ROUTE_CLUSTER	16
+#define ROUTE_NODST	(-MAXU16)
+
+/* see route_pathfind.cpp */
+bool PassableFromToTile(const Heroes &, const s32 &, const s32 &, const Direction::vector_t &, const s32 &);
+u16  GetPenaltyFromTo(const s32 &, const s32 &, const Direction::vector_t &, const u8 &);
+
+namespace
+{
+    struct ClusterRect
+    {
+	ClusterRect(u16 cluster)
+	{
+	    const u16 columns = (world.w() + ROUTE_CLUSTER - 1) / ROUTE_CLUSTER;
+
+	    x1 = (cluster % columns) * ROUTE_CLUSTER;
+	    y1 = (cluster / columns) * ROUTE_CLUSTER;
+	    x2 = std::min(x1 + ROUTE_CLUSTER, static_cast<int>(world.w()));
+	    y2 = std::min(y1 + ROUTE_CLUSTER, static_cast<int>(world.h()));
+	}
+
+	bool isInside(s32 index) const
+	{
+	    const s32 x = index % world.w();
+	    const s32 y = index / world.w();
+	    return x1 <= x && x < x2 && y1 <= y && y < y2;
+	}
+
+	u16 GetLocal(s32 index) const
+	{
+	    return (index / world.w() - y1) * ROUTE_CLUSTER + (index % world.w() - x1);
+	}
+
+	s32 x1, y1, x2, y2;
+    };
+
+    struct AbstractNode
+    {
+	AbstractNode() : cost(MAXU32), parent(-1), closed(false) {}
+
+	u32	cost;
+	s32	parent;
+	bool	closed;
+    };
+}
+
+Route::Corridor::Corridor() : clusters(Hierarchy::CountClusters(), 0)
+{
+}
+
+void Route::Corridor::Add(const s32 & index)
+{
+    clusters[Hierarchy::GetCluster(index)] = 1;
+}
+
+bool Route::Corridor::isAllow(const s32 & index) const
+{
+    return clusters[Hierarchy::GetCluster(index)];
+}
+
+Route::Hierarchy::Hierarchy()
+{
+}
+
+void Route::Hierarchy::Reset(void)
+{
+    graphs.clear();
+}
+
+u16 Route::Hierarchy::CountClusters(void)
+{
+    return ((world.w() + ROUTE_CLUSTER - 1) / ROUTE_CLUSTER) *
+	    ((world.h() + ROUTE_CLUSTER - 1) / ROUTE_CLUSTER);
+}
+
+u16 Route::Hierarchy::GetCluster(const s32 & index)
+{
+    const u16 columns = (world.w() + ROUTE_CLUSTER - 1) / ROUTE_CLUSTER;
+    return (index / world.w() / ROUTE_CLUSTER) * columns + (index % world.w()) / ROUTE_CLUSTER;
+}
+
+bool Route::Hierarchy::isEnabled(const s32 & from, const s32 & to)
+{
+    return Settings::Get().RouteTolerance() &&
+	Maps::XLARGE <= world.w() &&
+	Maps::isValidAbsIndex(from) && Maps::isValidAbsIndex(to) &&
+	2 * ROUTE_CLUSTER <= Maps::GetApproximateDistance(from, to);
+}
+
+void Route::Hierarchy::Invalidate(const s32 & index)
+{
+    if(graphs.empty() || ! Maps::isValidAbsIndex(index)) return;
+
+    // passable and monster protection: tile and around
+    Maps::Indexes around = Maps::GetAroundIndexes(index);
+    around.push_back(index);
+
+    for(std::map<u16, Graph>::iterator
+	it = graphs.begin(); it != graphs.end(); ++it)
+    {
+	Graph & graph = (*it).second;
+
+	if(graph.dirty.size())
+	    for(Maps::Indexes::const_iterator
+		ii = around.begin(); ii != around.end(); ++ii)
+		graph.dirty[GetCluster(*ii)] = 1;
+    }
+}
+
+void Route::Hierarchy::Update(Graph & graph, const Heroes & hero)
+{
+    const u16 count = CountClusters();
+
+    if(graph.dirty.size() != count)
+    {
+	graph.masks.assign(world.w() * world.h(), 0);
+	graph.clusters.assign(count, Cluster());
+	graph.dirty.assign(count, 1);
+    }
+
+    if(graph.dirty.end() == std::find(graph.dirty.begin(), graph.dirty.end(), 1))
+	return;
+
+    const u16 columns = (world.w() + ROUTE_CLUSTER - 1) / ROUTE_CLUSTER;
+
+    // entrances of the neighbours depends from the dirty cluster
+    std::vector<u8> rebuild(count, 0);
+
+    for(u16 cluster = 0; cluster < count; ++cluster) if(graph.dirty[cluster])
+    {
+	ComputeMasks(graph, cluster, hero);
+
+	rebuild[cluster] = 1;
+	if(cluster >= columns) rebuild[cluster - columns] = 1;
+	if(cluster + columns < count) rebuild[cluster + columns] = 1;
+	if(cluster % columns) rebuild[cluster - 1] = 1;
+	if((cluster + 1) % columns && cluster + 1 < count) rebuild[cluster + 1] = 1;
+    }
+
+    for(u16 cluster = 0; cluster < count; ++cluster) if(rebuild[cluster])
+    {
+	ComputeEntrances(graph, cluster);
+	ComputeEdges(graph, cluster);
+	graph.dirty[cluster] = 0;
+    }
+}
+
+void Route::Hierarchy::ComputeMasks(Graph & graph, u16 cluster, const Heroes & hero)
+{
+    const ClusterRect rect(cluster);
+
+    for(s32 y = rect.y1; y < rect.y2; ++y)
+	for(s32 x = rect.x1; x < rect.x2; ++x)
+    {
+	const s32 index = Maps::GetIndexFromAbsPoint(x, y);
+	u16 & mask = graph.masks[index];
+
+	mask = 0;
+
+	for(Direction::vector_t
+	    direct = Direction::TOP_LEFT; direct != Direction::CENTER; ++direct)
+    	    if(Maps::isValidDirection(index, direct) &&
+		PassableFromToTile(hero, index, Maps::GetDirectionIndex(index, direct), direct, ROUTE_NODST))
+		mask |= direct;
+    }
+}
+
+void Route::Hierarchy::ComputeEntrances(Graph & graph, u16 cluster)
+{
+    const ClusterRect rect(cluster);
+    Cluster & cl = graph.clusters[cluster];
+
+    cl.nodes.clear();
+    cl.edges.clear();
+
+    const Direction::vector_t sides[] = { Direction::TOP, Direction::RIGHT, Direction::BOTTOM, Direction::LEFT };
+
+    for(u8 side = 0; side < 4; ++side)
+    {
+	const Direction::vector_t direct = sides[side];
+	const bool horizontal = Direction::TOP == direct || Direction::BOTTOM == direct;
+	const s32 first = horizontal ? rect.x1 : rect.y1;
+	const s32 last = horizontal ? rect.x2 : rect.y2;
+	s32 run = -1;
+
+	// border tiles, the last position closes a run
+	for(s32 pos = first; pos <= last; ++pos)
+	{
+	    bool open = false;
+	    s32 index = -1;
+
+	    if(pos < last)
+	    {
+		switch(direct)
+		{
+		    case Direction::TOP:	index = Maps::GetIndexFromAbsPoint(pos, rect.y1); break;
+		    case Direction::BOTTOM:	index = Maps::GetIndexFromAbsPoint(pos, rect.y2 - 1); break;
+		    case Direction::LEFT:	index = Maps::GetIndexFromAbsPoint(rect.x1, pos); break;
+		    default:			index = Maps::GetIndexFromAbsPoint(rect.x2 - 1, pos); break;
+		}
+
+		if(Maps::isValidDirection(index, direct))
+		{
+		    const s32 other = Maps::GetDirectionIndex(index, direct);
+		    // symmetric: the neighbour cluster selects the same entrances
+		    open = (graph.masks[index] & direct) ||
+			    (graph.masks[other] & Direction::Reflect(direct));
+		}
+	    }
+
+	    if(open && run < 0)
+		run = pos;
+	    else
+	    if(!open && 0 <= run)
+	    {
+		std::vector<s32> entrances;
+
+		// long run: two entrances at the ends
+		if(6 <= pos - run)
+		{
+		    entrances.push_back(run);
+		    entrances.push_back(pos - 1);
+		}
+		else
+		    entrances.push_back((run + pos - 1) / 2);
+
+		for(std::vector<s32>::const_iterator
+		    it = entrances.begin(); it != entrances.end(); ++it)
+		{
+		    s32 node = 0;
+
+		    switch(direct)
+		    {
+			case Direction::TOP:	node = Maps::GetIndexFromAbsPoint(*it, rect.y1); break;
+			case Direction::BOTTOM:	node = Maps::GetIndexFromAbsPoint(*it, rect.y2 - 1); break;
+			case Direction::LEFT:	node = Maps::GetIndexFromAbsPoint(rect.x1, *it); break;
+			default:		node = Maps::GetIndexFromAbsPoint(rect.x2 - 1, *it); break;
+		    }
+
+		    if(cl.nodes.end() == std::find(cl.nodes.begin(), cl.nodes.end(), node))
+			cl.nodes.push_back(node);
+
+		    if(graph.masks[node] & direct)
+		    {
+			const s32 other = Maps::GetDirectionIndex(node, direct);
+			cl.edges.push_back(Edge(node, other,
+				GetPenaltyFromTo(node, other, direct, graph.pathfinding)));
+		    }
+		}
+
+		run = -1;
+	    }
+	}
+    }
+}
+
+void Route::Hierarchy::ComputeEdges(Graph & graph, u16 cluster)
+{
+    const ClusterRect rect(cluster);
+    Cluster & cl = graph.clusters[cluster];
+    std::vector<u32> costs;
+
+    for(std::vector<s32>::const_iterator
+	it1 = cl.nodes.begin(); it1 != cl.nodes.end(); ++it1)
+    {
+	FindInCluster(graph, cluster, *it1, graph.masks[*it1], costs);
+
+	for(std::vector<s32>::const_iterator
+	    it2 = cl.nodes.begin(); it2 != cl.nodes.end(); ++it2)
+	    if(it1 != it2 && MAXU32 != costs[rect.GetLocal(*it2)])
+		cl.edges.push_back(Edge(*it1, *it2, costs[rect.GetLocal(*it2)]));
+    }
+}
+
+/* dijkstra inside the cluster, costs by local index */
+void Route::Hierarchy::FindInCluster(const Graph & graph, u16 cluster, const s32 & start, u16 mask, std::vector<u32> & costs) const
+{
+    const ClusterRect rect(cluster);
+    std::set< std::pair<u32, s32> > opened;
+
+    costs.assign(ROUTE_CLUSTER * ROUTE_CLUSTER, MAXU32);
+    costs[rect.GetLocal(start)] = 0;
+    opened.insert(std::make_pair(0, start));
+
+    while(opened.size())
+    {
+	const u32 cost = (*opened.begin()).first;
+	const s32 cur = (*opened.begin()).second;
+	opened.erase(opened.begin());
+
+	if(cost > costs[rect.GetLocal(cur)]) continue;
+
+	const u16 passable = cur == start ? mask : graph.masks[cur];
+
+	for(Direction::vector_t
+	    direct = Direction::TOP_LEFT; direct != Direction::CENTER; ++direct)
+	    if(passable & direct)
+	{
+	    const s32 next = Maps::GetDirectionIndex(cur, direct);
+	    if(! rect.isInside(next)) continue;
+
+	    const u32 total = cost + GetPenaltyFromTo(cur, next, direct, graph.pathfinding);
+	    u32 & best = costs[rect.GetLocal(next)];
+
+	    if(total < best)
+	    {
+		best = total;
+		opened.insert(std::make_pair(total, next));
+	    }
+	}
+    }
+}
+
+bool Route::Hierarchy::GetCorridor(const Heroes & hero, const s32 & dst, Corridor & corridor, u32 & estimate)
+{
+    // the edge costs with the hero pathfinding, as the tile level search
+    const u8 pathfinding = hero.GetLevelSkill(Skill::Secondary::PATHFINDING);
+    const u16 key = (hero.GetColor() << 3) | (pathfinding << 1) | (hero.isShipMaster() ? 1 : 0);
+    Graph & graph = graphs[key];
+
+    graph.pathfinding = pathfinding;
+    Update(graph, hero);
+
+    const s32 & from = hero.GetIndex();
+    const u16 cluster1 = GetCluster(from);
+    const u16 cluster2 = GetCluster(dst);
+
+    // start: real passable from the hero position
+    u16 mask = 0;
+    for(Direction::vector_t
+	direct = Direction::TOP_LEFT; direct != Direction::CENTER; ++direct)
+    	if(Maps::isValidDirection(from, direct) &&
+	    PassableFromToTile(hero, from, Maps::GetDirectionIndex(from, direct), direct, dst))
+	    mask |= direct;
+
+    std::vector<u32> costs;
+    FindInCluster(graph, cluster1, from, mask, costs);
+
+    std::map<s32, AbstractNode> list;
+    std::set< std::pair<u32, s32> > opened;
+    const ClusterRect rect(cluster1);
+    const Cluster & start = graph.clusters[cluster1];
+
+    for(std::vector<s32>::const_iterator
+	it = start.nodes.begin(); it != start.nodes.end(); ++it)
+    {
+	const u32 & cost = costs[rect.GetLocal(*it)];
+
+	if(MAXU32 != cost)
+	{
+	    list[*it].cost = cost;
+	    list[*it].parent = from;
+	    opened.insert(std::make_pair(cost + 50 * Maps::GetApproximateDistance(*it, dst), *it));
+	}
+    }
+
+    s32 found = -1;
+
+    while(opened.size())
+    {
+	const s32 cur = (*opened.begin()).second;
+	opened.erase(opened.begin());
+
+	AbstractNode & node = list[cur];
+	if(node.closed) continue;
+	node.closed = true;
+
+	if(GetCluster(cur) == cluster2)
+	{
+	    found = cur;
+	    break;
+	}
+
+	const Cluster & cl = graph.clusters[GetCluster(cur)];
+
+	for(std::vector<Edge>::const_iterator
+	    it = cl.edges.begin(); it != cl.edges.end(); ++it)
+	    if((*it).from == cur)
+	{
+	    AbstractNode & next = list[(*it).to];
+	    const u32 cost = list[cur].cost + (*it).cost;
+
+	    if(!next.closed && cost < next.cost)
+	    {
+		next.cost = cost;
+		next.parent = cur;
+		opened.insert(std::make_pair(cost + 50 * Maps::GetApproximateDistance((*it).to, dst), (*it).to));
+	    }
+	}
+    }
+
+    if(found < 0)
+    {
+	DEBUG(DBG_OTHER, DBG_TRACE, "not found" << ", from: " << from << ", to: " << dst);
+	return false;
+    }
+
+    // the last cluster: from the entrance to the destination, or to the last step before it
+    const ClusterRect rect2(cluster2);
+    u32 last = MAXU32;
+
+    FindInCluster(graph, cluster2, found, graph.masks[found], costs);
+
+    if(rect2.isInside(dst))
+	last = costs[rect2.GetLocal(dst)];
+
+    for(Direction::vector_t
+	direct = Direction::TOP_LEFT; direct != Direction::CENTER; ++direct)
+    	if(Maps::isValidDirection(dst, direct))
+    {
+	const s32 around = Maps::GetDirectionIndex(dst, direct);
+	const Direction::vector_t reflect = Direction::Reflect(direct);
+
+	if(rect2.isInside(around) && MAXU32 != costs[rect2.GetLocal(around)] &&
+	    PassableFromToTile(hero, around, dst, reflect, dst))
+	    last = std::min(last, costs[rect2.GetLocal(around)] + GetPenaltyFromTo(around, dst, reflect, pathfinding));
+    }
+
+    if(MAXU32 == last)
+    {
+	DEBUG(DBG_OTHER, DBG_TRACE, "not found" << ", from: " << found << ", to: " << dst);
+	return false;
+    }
+
+    estimate = list[found].cost + last;
+
+    corridor.Add(from);
+    corridor.Add(dst);
+
+    for(s32 cur = found; cur != from; cur = list[cur].parent)
+	corridor.Add(cur);
+
+    DEBUG(DBG_OTHER, DBG_TRACE, "from: " << from << ", to: " << dst << ", estimate: " << estimate);
+
+    return true;
+}
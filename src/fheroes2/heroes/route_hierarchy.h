@@ -0,0 +1,98 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef H2ROUTEHIERARCHY_H
+#define H2ROUTEHIERARCHY_H
+
+#include <map>
+#include <vector>
+#include "gamedefs.h"
+
+class Heroes;
+
+namespace Route
+{
+    /* clusters allowed for tile level search */
+    class Corridor
+    {
+	public:
+	    Corridor();
+
+	    void	Add(const s32 &);
+	    bool	isAllow(const s32 &) const;
+
+	private:
+	    std::vector<u8> clusters;
+    };
+
+    /* HPA*: the map is split to clusters, entrances between clusters
+       are linked by precomputed paths inside the cluster */
+    class Hierarchy
+    {
+	public:
+	    Hierarchy();
+
+	    void	Reset(void);
+	    void	Invalidate(const s32 &);
+	    bool	GetCorridor(const Heroes &, const s32 & dst, Corridor &, u32 & estimate);
+
+	    static bool	isEnabled(const s32 & from, const s32 & to);
+	    static u16	GetCluster(const s32 &);
+	    static u16	CountClusters(void);
+
+	private:
+	    struct Edge
+	    {
+		Edge(s32 f, s32 t, u32 c) : from(f), to(t), cost(c) {}
+
+		s32	from;
+		s32	to;
+		u32	cost;
+	    };
+
+	    struct Cluster
+	    {
+		std::vector<s32>	nodes;	// entrances
+		std::vector<Edge>	edges;	// from entrances: inside cluster and to neighbour
+	    };
+
+	    struct Graph
+	    {
+		Graph() : pathfinding(0) {}
+
+		u8			pathfinding; // the edge costs level
+		std::vector<u16>	masks;	// passable directions, by tile
+		std::vector<Cluster>	clusters;
+		std::vector<u8>		dirty;
+	    };
+
+	    void	Update(Graph &, const Heroes &);
+	    void	ComputeMasks(Graph &, u16 cluster, const Heroes &);
+	    void	ComputeEntrances(Graph &, u16 cluster);
+	    void	ComputeEdges(Graph &, u16 cluster);
+	    void	FindInCluster(const Graph &, u16 cluster, const s32 & start, u16 mask, std::vector<u32> &) const;
+
+	    std::map<u16, Graph> graphs; // key: hero color, pathfinding, ship master
+    };
+}
+
+#endif
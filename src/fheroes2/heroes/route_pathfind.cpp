@@ -22,6 +22,11 @@
 
 #include <cstdlib>
 #include <map>
+#include <set>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include "thread.h"
 #include "maps.h"
 #include "ai.h"
 #include "world.h"
@@ -54,41 +59,65 @@ u16 GetCurrentLength(std::map<s32, cell_t> & list, s32 from)
     return res;
 }
 
-bool CheckMonsterProtectionAndNotDst(const s32 & to, const s32 & dst)
+/* the passability checks read the tiles through a view:
+   the world for the usual search, a snapshot for the background search */
+class RouteWorldView
 {
-    const MapsIndexes & monsters = Maps::GetTilesUnderProtection(to);
-    return monsters.size() && monsters.end() == std::find(monsters.begin(), monsters.end(), dst);
+public:
+    RouteWorldView(const Heroes & h) : hero(h),
+	skipfog(CONTROL_AI == h.GetControl() ? AI::HeroesSkipFog() : false) {}
+
+    s32  GetHeroIndex(void) const { return hero.GetIndex(); }
+    bool isShipMaster(void) const { return hero.isShipMaster(); }
+    u8   GetObject(const s32 & index, bool skip_hero = true) const { return world.GetTiles(index).GetObject(skip_hero); }
+    u16  GetPassable(const s32 & index) const { return world.GetTiles(index).GetPassable(); }
+    u16  GetProtection(const s32 & index) const { return world.GetProtection(index); }
+    bool isWater(const s32 & index) const { return world.GetTiles(index).isWater(); }
+    bool isPassable(const s32 & index, u16 direct, bool check_hero) const
+    { return world.GetTiles(index).isPassable(check_hero ? &hero : NULL, direct, skipfog); }
+
+private:
+    const Heroes & hero;
+    const bool skipfog;
+};
+
+template<class View>
+bool CheckMonsterProtectionAndNotDst(const View & view, const s32 & to, const s32 & dst)
+{
+    const u16 protection = view.GetProtection(to);
+    return protection && ! (protection & Direction::Get(to, dst));
 }
 
-bool PassableToTile(const Heroes & hero, const Maps::Tiles & toTile, const Direction::vector_t & direct, const s32 & dst)
+template<class View>
+bool PassableToTile(const View & view, const s32 & to, const Direction::vector_t & direct, const s32 & dst)
 {
     // check end point
-    if(toTile.GetIndex() == dst)
+    if(to == dst)
     {
 	// fix toTilePassable with action object
-	if(MP2::isPickupObject(toTile.GetObject()))
+	if(MP2::isPickupObject(view.GetObject(to)))
 	    return true;
 
 	// check direct to object
-	if(MP2::isActionObject(toTile.GetObject(false), hero.isShipMaster()))
-	    return Direction::Reflect(direct) & toTile.GetPassable();
+	if(MP2::isActionObject(view.GetObject(to, false), view.isShipMaster()))
+	    return Direction::Reflect(direct) & view.GetPassable(to);
 
-	if(MP2::OBJ_HEROES == toTile.GetObject())
-	    return toTile.isPassable(NULL, Direction::Reflect(direct), (CONTROL_AI == hero.GetControl() ? AI::HeroesSkipFog() : false));
+	if(MP2::OBJ_HEROES == view.GetObject(to))
+	    return view.isPassable(to, Direction::Reflect(direct), false);
     }
 
     // check to tile direct
-    if(! toTile.isPassable(&hero, Direction::Reflect(direct), (CONTROL_AI == hero.GetControl() ? AI::HeroesSkipFog() : false)))
+    if(! view.isPassable(to, Direction::Reflect(direct), true))
 	return false;
 
-    if(toTile.GetIndex() != dst)
+    if(to != dst)
     {
-	if(MP2::isPickupObject(toTile.GetObject()) ||
-	    MP2::isActionObject(toTile.GetObject(false), hero.isShipMaster()))
+	if(MP2::isPickupObject(view.GetObject(to)) ||
+	    MP2::isActionObject(view.GetObject(to, false), view.isShipMaster()))
 	    return false;
 
 	// check hero/monster on route
-	switch(toTile.GetObject())
+	switch(view.GetObject(to))
 	{
 	    case MP2::OBJ_HEROES:
 	    case MP2::OBJ_MONSTER:
@@ -98,53 +127,51 @@ bool PassableToTile(const Heroes & hero, const Maps::Tiles & toTile, const Direc
 	}
 
 	// check monster protection
-	if(CheckMonsterProtectionAndNotDst(toTile.GetIndex(), dst))
+	if(CheckMonsterProtectionAndNotDst(view, to, dst))
 	    return false;
     }
 
     return true;
 }
 
-bool PassableFromToTile(const Heroes & hero, const s32 & from, const s32 & to, const Direction::vector_t & direct, const s32 & dst)
+template<class View>
+bool PassableFromToTile(const View & view, const s32 & from, const s32 & to, const Direction::vector_t & direct, const s32 & dst)
 {
-    const Maps::Tiles & fromTile = world.GetTiles(from);
-    const Maps::Tiles & toTile = world.GetTiles(to);
-
     // check start point
-    if(hero.GetIndex() == from)
+    if(view.GetHeroIndex() == from)
     {
-	if(MP2::isActionObject(fromTile.GetObject(false), hero.isShipMaster()))
+	if(MP2::isActionObject(view.GetObject(from, false), view.isShipMaster()))
 	{
 	    // check direct from object
-	    if(! (direct & fromTile.GetPassable()))
+	    if(! (direct & view.GetPassable(from)))
 		return false;
 	}
 	else
 	{
 	    // check from tile direct
-	    if(! fromTile.isPassable(&hero, direct, (CONTROL_AI == hero.GetControl() ? AI::HeroesSkipFog() : false)))
+	    if(! view.isPassable(from, direct, true))
 		return false;
 	}
     }
     else
     {
-	if(MP2::isActionObject(fromTile.GetObject(), hero.isShipMaster()))
+	if(MP2::isActionObject(view.GetObject(from), view.isShipMaster()))
 	{
 	    // check direct from object
-	    if(! (direct & fromTile.GetPassable()))
+	    if(! (direct & view.GetPassable(from)))
 		return false;
 	}
 	else
 	{
 	    // check from tile direct
-	    if(! fromTile.isPassable(&hero, direct, (CONTROL_AI == hero.GetControl() ? AI::HeroesSkipFog() : false)))
+	    if(! view.isPassable(from, direct, true))
 		return false;
 	}
     }
 
-    if(fromTile.isWater() && !toTile.isWater())
+    if(view.isWater(from) && !view.isWater(to))
     {
-	switch(toTile.GetObject())
+	switch(view.GetObject(to))
 	{
 	    case MP2::OBJ_BOAT:
             case MP2::OBJ_MONSTER:
@@ -152,27 +179,32 @@ bool PassableFromToTile(const Heroes & hero, const s32 & from, const s32 & to, c
                 return false;
 
 	    case MP2::OBJ_COAST:
-		return toTile.GetIndex() == dst;
+		return to == dst;
 
 	    default: break;
 	}
     }
     else
-    if(!fromTile.isWater() && toTile.isWater())
+    if(!view.isWater(from) && view.isWater(to))
     {
-	switch(toTile.GetObject())
+	switch(view.GetObject(to))
 	{
 	    case MP2::OBJ_BOAT:
                 return true;
 
             case MP2::OBJ_HEROES:
-		return toTile.GetIndex() == dst;
+		return to == dst;
 
 	    default: break;
 	}
     }
 
-    return PassableToTile(hero, toTile, direct, dst);
+    return PassableToTile(view, to, direct, dst);
+}
+
+bool PassableFromToTile(const Heroes & hero, const s32 & from, const s32 & to, const Direction::vector_t & direct, const s32 & dst)
+{
+    return PassableFromToTile(RouteWorldView(hero), from, to, direct, dst);
 }
 
 u16 GetPenaltyFromTo(const s32 & from, const s32 & to, const Direction::vector_t & direct, const u8 & pathfinding)
@@ -182,7 +214,7 @@ u16 GetPenaltyFromTo(const s32 & from, const s32 & to, const Direction::vector_t
     return (cost1 + cost2) >> 1;
 }
 
-bool Route::Path::Find(const s32 & to, const u16 limit)
+bool Route::Path::Find(const s32 & to, const u16 limit, const Corridor* corridor)
 {
     const u8 pathfinding = hero.GetLevelSkill(Skill::Secondary::PATHFINDING);
     const s32 & from = hero.GetIndex();
@@ -212,6 +244,8 @@ bool Route::Path::Find(const s32 & to, const u16 limit)
 	    {
 		tmp = Maps::GetDirectionIndex(cur, direct);
 
+		if(corridor && ! corridor->isAllow(tmp)) continue;
+
 		if(list[tmp].open)
 		{
 		    const u16 costg = GetPenaltyFromTo(cur, tmp, direct, pathfinding);
@@ -312,3 +346,509 @@ bool Route::Path::Find(const s32 & to, const u16 limit)
 
     return !empty();
 }
+
+Route::DistanceField::DistanceField() : hero(NULL), from(-1), day(0), complete(false)
+{
+}
+
+bool Route::DistanceField::isValid(const Heroes & h) const
+{
+    return hero == &h && from == h.GetIndex() && day == world.CountDay() &&
+	costs.size() == static_cast<size_t>(world.w() * world.h());
+}
+
+bool Route::DistanceField::isComplete(void) const
+{
+    return complete;
+}
+
+bool Route::DistanceField::isReachable(const s32 & index) const
+{
+    return MAXU16 != Get(index);
+}
+
+/* the tile change may modify the field */
+bool Route::DistanceField::isAffected(const s32 & index) const
+{
+    if(isReachable(index)) return true;
+
+    for(Direction::vector_t
+	direct = Direction::TOP_LEFT; direct != Direction::CENTER; ++direct)
+	if(Maps::isValidDirection(index, direct) &&
+	    isReachable(Maps::GetDirectionIndex(index, direct))) return true;
+
+    return false;
+}
+
+u16 Route::DistanceField::Get(const s32 & index) const
+{
+    return Maps::isValidAbsIndex(index) && index < static_cast<s32>(costs.size()) ? costs[index] : MAXU16;
+}
+
+void Route::DistanceField::Set(const s32 & index, u32 cost, bool transit)
+{
+    if(MAXU16 == costs[index]) touched.push_back(index);
+    if(cost < costs[index]) costs[index] = cost;
+
+    if(transit && cost < transits[index])
+    {
+	transits[index] = cost;
+	opened.push_back(std::make_pair(cost, index));
+	std::push_heap(opened.begin(), opened.end(), std::greater< std::pair<u32, s32> >());
+    }
+}
+
+/* dijkstra from the hero: transit tiles are expanded, the target only tiles (action objects,
+   heroes, monster protection) get the cost for the last step */
+void Route::DistanceField::Calculate(const Heroes & h, const u16 limit)
+{
+    const u8 pathfinding = h.GetLevelSkill(Skill::Secondary::PATHFINDING);
+    const s32 size = world.w() * world.h();
+
+    if(costs.size() != static_cast<size_t>(size))
+    {
+	costs.assign(size, MAXU16);
+	transits.assign(size, MAXU16);
+	touched.clear();
+    }
+    else
+    {
+	for(std::vector<s32>::const_iterator
+	    it = touched.begin(); it != touched.end(); ++it)
+	{
+	    costs[*it] = MAXU16;
+	    transits[*it] = MAXU16;
+	}
+	touched.clear();
+    }
+
+    hero = &h;
+    from = h.GetIndex();
+    day = world.CountDay();
+    complete = true;
+    opened.clear();
+
+    if(! Maps::isValidAbsIndex(from)) return;
+
+    Set(from, 0, true);
+
+    while(opened.size())
+    {
+	std::pop_heap(opened.begin(), opened.end(), std::greater< std::pair<u32, s32> >());
+	const u32 cost = opened.back().first;
+	const s32 cur = opened.back().second;
+	opened.pop_back();
+
+	if(cost > transits[cur]) continue;
+
+	for(Direction::vector_t
+	    direct = Direction::TOP_LEFT; direct != Direction::CENTER; ++direct)
+	{
+    	    if(! Maps::isValidDirection(cur, direct)) continue;
+
+	    const s32 tmp = Maps::GetDirectionIndex(cur, direct);
+	    const u32 total = cost + GetPenaltyFromTo(cur, tmp, direct, pathfinding);
+
+	    if(total >= transits[tmp]) continue;
+
+	    if(total >= limit)
+	    {
+		complete = false;
+		continue;
+	    }
+
+	    // not target: below any index of the direction
+	    if(PassableFromToTile(h, cur, tmp, direct, -MAXU16))
+		Set(tmp, total, true);
+	    else
+	    if(PassableFromToTile(h, cur, tmp, direct, tmp))
+	    {
+		Set(tmp, total, false);
+
+		// the protected tile is transit for the attack of the protecting monster
+		const u16 protection = world.GetProtection(tmp);
+
+		if(protection & ~Direction::CENTER)
+		    for(Direction::vector_t
+			direct2 = Direction::TOP_LEFT; direct2 != Direction::CENTER; ++direct2)
+			if((protection & direct2) && Maps::isValidDirection(tmp, direct2))
+		{
+		    const s32 monster = Maps::GetDirectionIndex(tmp, direct2);
+		    const u32 total2 = total + GetPenaltyFromTo(tmp, monster, direct2, pathfinding);
+
+		    if(total2 < limit &&
+			PassableFromToTile(h, tmp, monster, direct2, monster))
+			Set(monster, total2, false);
+		}
+	    }
+	}
+    }
+
+    DEBUG(DBG_OTHER, DBG_TRACE, h.GetName() << ", tiles: " << touched.size() << ", complete: " << (complete ? "yes" : "no"));
+}
+
+/* minimal step penalty: road, see Maps::Ground::MoveCost::Get */
+#define ROUTE_MIN_PENALTY	59
+
+/* long route: tile level search inside the clusters selected by Route::Hierarchy */
+bool Route::Path::FindHierarchy(const s32 & to, const u16 limit)
+{
+    if(! Hierarchy::isEnabled(hero.GetIndex(), to)) return false;
+
+    Corridor corridor;
+    u32 estimate = 0;
+
+    if(! world.GetRouteHierarchy().GetCorridor(hero, to, corridor, estimate) ||
+	! Find(to, limit, &corridor))
+    {
+	clear();
+	return false;
+    }
+
+    const u32 total = GetTotalPenalty();
+    // the lower bound of any route: the road penalty by each step
+    const u32 bound = ROUTE_MIN_PENALTY * Maps::GetApproximateDistance(hero.GetIndex(), to);
+
+    // the corridor cost is within the tolerance only by the optimal cost, else the full search
+    if(100 * total > bound * (100 + Settings::Get().RouteTolerance()))
+    {
+	DEBUG(DBG_OTHER, DBG_INFO, hero.GetName() << ", corridor cost: " << total <<
+		", estimate: " << estimate << ", bound: " << bound);
+	clear();
+	return false;
+    }
+
+#ifdef WITH_DEBUG
+    if(IS_DEBUG(DBG_OTHER, DBG_TRACE))
+    {
+	Path full(hero);
+	if(full.Find(to, limit))
+	    VERBOSE("route hierarchy, " << hero.GetName() << ", to: " << to <<
+		", cost: " << total << ", full cost: " << full.GetTotalPenalty());
+    }
+#endif
+
+    return true;
+}
+
+/* async route: only short routes are calculated immediately */
+#define ASYNC_ROUTE_DISTANCE	24
+
+namespace Route
+{
+    enum { ASYNC_WATER = 0x01, ASYNC_FOG = 0x02, ASYNC_FOG_CURRENT = 0x04, ASYNC_HERO_PASSABLE = 0x08 };
+
+    /* tile data of the background search, copied from the world at the request */
+    struct AsyncTile
+    {
+	u16	passable;
+	u16	protection;
+	Maps::Ground::MoveCost cost;
+	u8	object;
+	u8	object_base;	// without hero
+	u8	flags;
+    };
+
+    struct AsyncRequest
+    {
+	AsyncRequest() : owner(NULL), from(-1), to(-1), limit(MAXU16), pathfinding(0), ship(false),
+	    cancel(false), done(false), progress(0) {}
+
+	void	SetTiles(const Heroes &);
+	bool	isCancel(void) const;
+	bool	isDone(void) const;
+	u8	GetProgress(void) const;
+	void	SetProgress(u8);
+
+	const Path*			owner;
+	s32				from;
+	s32				to;
+	u16				limit;
+	u8				pathfinding;
+	bool				ship;
+	std::vector<AsyncTile>		tiles;
+	std::list<Step>			result;
+	bool				cancel;
+	bool				done;
+	u8				progress;
+	SDL::Mutex			mutex;
+	SDL::Thread			thread;
+    };
+
+    /* the passability view over the snapshot, see RouteWorldView */
+    class AsyncView
+    {
+    public:
+	AsyncView(const AsyncRequest & r) : req(r) {}
+
+	s32  GetHeroIndex(void) const { return req.from; }
+	bool isShipMaster(void) const { return req.ship; }
+	u8   GetObject(const s32 & index, bool skip_hero = true) const
+	{ return skip_hero ? req.tiles[index].object : req.tiles[index].object_base; }
+	u16  GetPassable(const s32 & index) const { return req.tiles[index].passable; }
+	u16  GetProtection(const s32 & index) const { return req.tiles[index].protection; }
+	bool isWater(const s32 & index) const { return req.tiles[index].flags & ASYNC_WATER; }
+	bool isPassable(const s32 & index, u16 direct, bool check_hero) const
+	{
+	    const AsyncTile & tile = req.tiles[index];
+	    if(tile.flags & (check_hero ? ASYNC_FOG : ASYNC_FOG_CURRENT)) return false;
+	    if(check_hero && !(tile.flags & ASYNC_HERO_PASSABLE)) return false;
+	    return direct & tile.passable;
+	}
+	u16  GetPenaltyFromTo(const s32 & from, const s32 & to, Direction::vector_t direct) const
+	{
+	    return (req.tiles[from].cost.Get(direct, req.pathfinding) +
+		    req.tiles[to].cost.Get(Direction::Reflect(direct), req.pathfinding)) >> 1;
+	}
+
+    private:
+	const AsyncRequest & req;
+    };
+}
+
+void Route::AsyncRequest::SetTiles(const Heroes & hero)
+{
+    const s32 size = world.w() * world.h();
+    const bool skipfog = CONTROL_AI == hero.GetControl() ? AI::HeroesSkipFog() : false;
+    const u8 color = hero.GetColor();
+    const u8 current = Settings::Get().CurrentColor();
+
+    tiles.resize(size);
+
+    for(s32 index = 0; index < size; ++index)
+    {
+	const Maps::Tiles & tile = world.GetTiles(index);
+	AsyncTile & res = tiles[index];
+
+	res.passable = tile.GetPassable();
+	res.protection = world.GetProtection(index);
+	res.object = tile.GetObject();
+	res.object_base = tile.GetObject(false);
+	res.flags = 0;
+
+	if(tile.isWater()) res.flags |= ASYNC_WATER;
+	if(!skipfog && tile.isFog(color)) res.flags |= ASYNC_FOG;
+	if(!skipfog && tile.isFog(current)) res.flags |= ASYNC_FOG_CURRENT;
+	if(tile.isPassable(hero)) res.flags |= ASYNC_HERO_PASSABLE;
+
+	const Maps::Ground::MoveCost* cost = world.GetMoveCost(index);
+	if(cost)
+	    res.cost = *cost;
+	else
+	    res.cost.Set(index);
+    }
+}
+
+bool Route::AsyncRequest::isCancel(void) const
+{
+    mutex.Lock();
+    const bool res = cancel;
+    mutex.Unlock();
+    return res;
+}
+
+bool Route::AsyncRequest::isDone(void) const
+{
+    mutex.Lock();
+    const bool res = done;
+    mutex.Unlock();
+    return res;
+}
+
+u8 Route::AsyncRequest::GetProgress(void) const
+{
+    mutex.Lock();
+    const u8 res = progress;
+    mutex.Unlock();
+    return res;
+}
+
+void Route::AsyncRequest::SetProgress(u8 value)
+{
+    mutex.Lock();
+    if(value > progress) progress = value;
+    mutex.Unlock();
+}
+
+static Route::AsyncRequest route_async;
+
+int RouteAsyncWorker(void* param)
+{
+    Route::AsyncRequest & req = *static_cast<Route::AsyncRequest*>(param);
+    const Route::AsyncView view(req);
+
+    // the same search as Route::Path::Find, only the expanded tiles are checked
+    std::vector<cell_t> list(req.tiles.size());
+    std::vector<u16> length(req.tiles.size(), 0);
+    std::set< std::pair<s32, s32> > opened;
+
+    const u16 distance = Maps::GetApproximateDistance(req.from, req.to);
+    s32 cur = req.from;
+    bool cancel = false;
+
+    list[cur].cost_g = 0;
+    list[cur].cost_t = 0;
+    list[cur].parent = -1;
+    list[cur].open   = 0;
+
+    while(cur != req.to && !(cancel = req.isCancel()))
+    {
+	for(Direction::vector_t
+	    direct = Direction::TOP_LEFT; direct != Direction::CENTER; ++direct)
+	{
+	    if(! Maps::isValidDirection(cur, direct)) continue;
+
+	    const s32 tmp = Maps::GetDirectionIndex(cur, direct);
+	    cell_t & cell = list[tmp];
+
+	    if(!cell.open) continue;
+
+	    const u16 costg = view.GetPenaltyFromTo(cur, tmp, direct);
+
+	    // new or check alt
+	    if((-1 == cell.parent || cell.cost_t > list[cur].cost_t + costg) &&
+		PassableFromToTile(view, cur, tmp, direct, req.to))
+	    {
+		if(-1 == cell.parent)
+		    cell.cost_d = 50 * Maps::GetApproximateDistance(tmp, req.to);
+		else
+		    opened.erase(std::make_pair(cell.cost_t + cell.cost_d, tmp));
+
+		cell.direct = direct;
+		cell.cost_g = costg;
+		cell.parent = cur;
+		cell.cost_t = list[cur].cost_t + costg;
+		length[tmp] = length[cur] + 1;
+
+		opened.insert(std::make_pair(cell.cost_t + cell.cost_d, tmp));
+	    }
+	}
+
+	list[cur].open = 0;
+
+	// find minimal cost
+	if(opened.empty() || MAXU16 <= (*opened.begin()).first) break;
+
+	cur = (*opened.begin()).second;
+	opened.erase(opened.begin());
+
+	if(distance)
+	{
+	    const u16 left = Maps::GetApproximateDistance(cur, req.to);
+	    req.SetProgress(left < distance ? 100 * (distance - left) / distance : 0);
+	}
+
+	if(length[cur] > req.limit) break;
+    }
+
+    std::list<Route::Step> result;
+
+    // save path
+    if(cur == req.to && !cancel)
+    {
+	while(cur != req.from)
+	{
+	    result.push_front(Route::Step(list[cur].parent, list[cur].direct, list[cur].cost_g));
+    	    cur = list[cur].parent;
+	}
+    }
+
+    req.mutex.Lock();
+    req.result.swap(result);
+    req.done = true;
+    req.progress = 100;
+    req.mutex.Unlock();
+
+    return 0;
+}
+
+bool Route::Path::RequestAsync(const s32 dst_index, const u16 limit)
+{
+    StopAsync();
+
+    if(!Maps::isValidAbsIndex(dst_index) ||
+	ASYNC_ROUTE_DISTANCE > Maps::GetApproximateDistance(hero.GetIndex(), dst_index))
+    {
+	Calculate(dst_index, limit);
+	return false;
+    }
+
+    dst = dst_index;
+    clear();
+
+    // the worker reads only this copy: the world may change during the search
+    route_async.owner = this;
+    route_async.from = hero.GetIndex();
+    route_async.to = dst_index;
+    route_async.limit = limit;
+    route_async.pathfinding = hero.GetLevelSkill(Skill::Secondary::PATHFINDING);
+    route_async.ship = hero.isShipMaster();
+    route_async.SetTiles(hero);
+    route_async.cancel = false;
+    route_async.done = false;
+    route_async.progress = 0;
+    route_async.result.clear();
+    route_async.mutex.Create();
+    route_async.thread.Create(RouteAsyncWorker, &route_async);
+
+    // threads not available
+    if(! route_async.thread.IsRun())
+    {
+	route_async.owner = NULL;
+	Calculate(dst_index, limit);
+	return false;
+    }
+
+    DEBUG(DBG_OTHER, DBG_INFO, hero.GetName() << ", from: " << route_async.from << ", to: " << dst_index);
+
+    return true;
+}
+
+bool Route::Path::UpdateAsync(void)
+{
+    if(!isPending() || !route_async.isDone()) return false;
+
+    route_async.thread.Wait();
+    route_async.owner = NULL;
+
+    // hero moved, result not actual
+    if(route_async.from == hero.GetIndex() && route_async.to == dst)
+    {
+	clear();
+	std::list<Step>::swap(route_async.result);
+	FixMonsterDestination();
+    }
+
+    DEBUG(DBG_OTHER, DBG_INFO, hero.GetName() << ", route: " << String());
+
+    return true;
+}
+
+void Route::Path::CancelAsync(void)
+{
+    if(isPending()) StopAsync();
+}
+
+bool Route::Path::isPending(void) const
+{
+    return route_async.owner == this;
+}
+
+u8 Route::Path::GetProgress(void) const
+{
+    return isPending() ? route_async.GetProgress() : 100;
+}
+
+void Route::Path::StopAsync(void)
+{
+    if(route_async.owner)
+    {
+	route_async.mutex.Lock();
+	route_async.cancel = true;
+	route_async.mutex.Unlock();
+
+	route_async.thread.Wait();
+	route_async.owner = NULL;
+	route_async.result.clear();
+    }
+}
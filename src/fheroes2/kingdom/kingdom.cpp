@@ -343,25 +343,28 @@ bool Kingdom::isVisited(const Maps::Tiles & tile) const
 
 bool Kingdom::isVisited(s32 index, u8 object) const
 {
-    std::list<IndexObject>::const_iterator it = std::find_if(visit_object.begin(), visit_object.end(), std::bind2nd(std::mem_fun_ref(&IndexObject::isIndex), index));
-    return visit_object.end() != it && (*it).isObject(object);
+    return visit_object.isVisited(index, object);
 }
 
 /* return true if object visited */
 bool Kingdom::isVisited(const u8 object) const
 {
-    return visit_object.end() != std::find_if(visit_object.begin(), visit_object.end(), std::bind2nd(std::mem_fun_ref(&IndexObject::isObject), object));
+    return visit_object.isVisited(object);
 }
 
 u16 Kingdom::CountVisitedObjects(const MP2::object_t object) const
 {
-    return std::count_if(visit_object.begin(), visit_object.end(), std::bind2nd(std::mem_fun_ref(&IndexObject::isObject), object));
+    return visit_object.Count(object);
 }
 
 /* set visited cell */
 void Kingdom::SetVisited(const s32 index, const MP2::object_t object)
 {
-    if(!isVisited(index, object) && object != MP2::OBJ_ZERO) visit_object.push_front(IndexObject(index, object));
+    if(!isVisited(index, object) && object != MP2::OBJ_ZERO)
+    {
+	visit_object.push_front(IndexObject(index, object));
+	AI::WorldObjectChanged(index, GetColor());
+    }
 }
 
 bool Kingdom::HeroesMayStillMove(void) const
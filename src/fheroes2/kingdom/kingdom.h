@@ -30,6 +30,7 @@
 #include "game.h"
 #include "mp2.h"
 #include "pairs.h"
+#include "visit.h"
 #include "heroes.h"
 #include "castle.h"
 #include "heroes_recruits.h"
@@ -163,7 +164,7 @@ private:
     Recruits recruits;
     LastLoseHero lost_hero;
 
-    std::list<IndexObject> visit_object;
+    VisitObjects visit_object;
 
     Puzzle puzzle_maps;
     u8 visited_tents_colors;
@@ -22,6 +22,7 @@
 
 #include <cstdlib> 
 #include <fstream>
+#include <iterator>
 #include <functional>
 #include <algorithm>
 #include "agg.h" 
@@ -39,19 +40,82 @@
 #include "pairs.h"
 #include "game_over.h"
 #include "resource.h"
+#include "game.h"
 #include "game_focus.h"
+#include "game_io.h"
 #include "world.h"
 #include "ai.h"
 
+u8 CapturedColorIndex(u8 color)
+{
+    const u8 index = Color::GetIndex(color);
+    return index < KINGDOMMAX ? index : (Color::NONE == color ? KINGDOMMAX : KINGDOMMAX + 1);
+}
+
+/* index sprite EXTRAOVR: ore, sulfur, crystal, gems, gold */
+s8 CapturedMinesTile(const s32 & index)
+{
+    const Maps::TilesAddon* addon = world.GetTiles(index).FindObjectConst(MP2::OBJ_MINES);
+    return addon && 5 > addon->index ? addon->index : -1;
+}
+
+s8 CapturedMinesType(u8 type)
+{
+    switch(type)
+    {
+	case Resource::ORE:	return 0;
+	case Resource::SULFUR:	return 1;
+	case Resource::CRYSTAL:	return 2;
+	case Resource::GEMS:	return 3;
+	case Resource::GOLD:	return 4;
+	default: break;
+    }
+
+    return -1;
+}
+
+CapturedObjects::CapturedObjects()
+{
+    Recount();
+}
+
 CapturedObject & CapturedObjects::Get(const s32 & index)
 {
     std::map<s32, CapturedObject> & my = *this;
     return my[index];
 }
 
+void CapturedObjects::Count(const s32 & index, const ObjectColor & objcol, s8 diff)
+{
+    if(MP2::OBJ_ZERO == objcol.first) return;
+
+    const u8 col = CapturedColorIndex(objcol.second);
+    objects[objcol.first][col] += diff;
+
+    // mine under the hero
+    if(MP2::OBJ_MINES == objcol.first || MP2::OBJ_HEROES == objcol.first)
+    {
+	const s8 mine = CapturedMinesTile(index);
+	if(0 <= mine) mines[mine][col] += diff;
+    }
+}
+
+void CapturedObjects::Recount(void)
+{
+    std::fill(&objects[0][0], &objects[0][0] + ARRAY_COUNT(objects) * ARRAY_COUNT(objects[0]), 0);
+    std::fill(&mines[0][0], &mines[0][0] + ARRAY_COUNT(mines) * ARRAY_COUNT(mines[0]), 0);
+
+    for(const_iterator it = begin(); it != end(); ++it)
+	Count((*it).first, (*it).second.objcol, 1);
+}
+
 void CapturedObjects::SetColor(const s32 & index, u8 col)
 {
-    Get(index).SetColor(col);
+    CapturedObject & co = Get(index);
+
+    Count(index, co.objcol, -1);
+    co.SetColor(col);
+    Count(index, co.objcol, 1);
 }
 
 void CapturedObjects::Set(const s32 & index, u8 obj, u8 col)
@@ -61,10 +125,37 @@ void CapturedObjects::Set(const s32 & index, u8 obj, u8 col)
     if(co.GetColor() != col && co.guardians.isValid())
 	co.guardians.Reset();
 
+    Count(index, co.objcol, -1);
     co.Set(obj, col);
+    Count(index, co.objcol, 1);
 }
 
 u16 CapturedObjects::GetCount(u8 obj, u8 col) const
+{
+    const u16 result = objects[obj][CapturedColorIndex(col)];
+
+#ifdef WITH_DEBUG
+    if(IS_DEBUG(DBG_GAME, DBG_TRACE) && result != ScanCount(obj, col))
+	DEBUG(DBG_GAME, DBG_WARN, MP2::StringObject(obj) << ", " << Color::String(col) << ", counter mismatch: " << result << ", scan: " << ScanCount(obj, col));
+#endif
+
+    return result;
+}
+
+u16 CapturedObjects::GetCountMines(u8 type, u8 col) const
+{
+    const s8 mine = CapturedMinesType(type);
+    const u16 result = 0 <= mine ? mines[mine][CapturedColorIndex(col)] : 0;
+
+#ifdef WITH_DEBUG
+    if(IS_DEBUG(DBG_GAME, DBG_TRACE) && result != ScanCountMines(type, col))
+	DEBUG(DBG_GAME, DBG_WARN, Resource::String(type) << ", " << Color::String(col) << ", counter mismatch: " << result << ", scan: " << ScanCountMines(type, col));
+#endif
+
+    return result;
+}
+
+u16 CapturedObjects::ScanCount(u8 obj, u8 col) const
 {
     u16 result = 0;
 
@@ -77,7 +168,7 @@ u16 CapturedObjects::GetCount(u8 obj, u8 col) const
     return result;
 }
 
-u16 CapturedObjects::GetCountMines(u8 type, u8 col) const
+u16 CapturedObjects::ScanCountMines(u8 type, u8 col) const
 {
     u16 result = 0;
 
@@ -153,7 +244,9 @@ void CapturedObjects::ResetColor(u8 color)
 
 	if(objcol.isColor(color))
 	{
+	    Count((*it).first, objcol, -1);
 	    objcol.second = Color::UNUSED;
+	    Count((*it).first, objcol, 1);
 	    world.GetTiles((*it).first).CaptureFlags32(objcol.first, objcol.second);
 	}
     }
@@ -213,9 +306,12 @@ void World::NewMaps(const u16 sw, const u16 sh)
     width = sw;
     height = sh;
 
-    AGG::Cache::PreloadObject(TIL::GROUND32);
+    // headless mode: skip sprites
+    if(SDL::SubSystem(INIT_VIDEO))
+	AGG::Cache::PreloadObject(TIL::GROUND32);
 
     vec_tiles.resize(width * height);
+    fog_planes.Reset(width, height);
 
     // init all tiles
     for(MapsTiles::iterator
@@ -239,6 +335,11 @@ void World::NewMaps(const u16 sw, const u16 sh)
 	(*it).Init(std::distance(vec_tiles.begin(), it), mp2tile);
     }
 
+    ComputeProtection();
+    ComputeMoveCosts();
+    ComputeCastlesIndex();
+    ComputeHeroesIndex();
+
     Maps::FileInfo & fi = Settings::Get().CurrentFileInfo();
 
     // reset current maps info
@@ -246,8 +347,69 @@ void World::NewMaps(const u16 sw, const u16 sh)
     fi.size_h = height;
 }
 
-/* load maps */
+/* check the mp2 blocks sizes: tiles, addons, castles, resources */
+bool CheckMP2(std::istream & fd, u32 endof_mp2)
+{
+    u32 mapw = 0;
+    u32 maph = 0;
+    u32 addons = 0;
+
+    if(endof_mp2 < MP2OFFSETDATA + sizeof(u32))
+	return false;
+
+    fd.seekg(MP2OFFSETDATA - 2 * sizeof(u32), std::ios_base::beg);
+    fd.read(reinterpret_cast<char *>(&mapw), sizeof(u32));
+    fd.read(reinterpret_cast<char *>(&maph), sizeof(u32));
+    SwapLE32(mapw);
+    SwapLE32(maph);
+
+    if(! fd.good() || 0 == mapw || 0 == maph || mapw > Maps::XLARGE3 || maph > Maps::XLARGE3)
+	return false;
+
+    u32 pos = MP2OFFSETDATA + mapw * maph * SIZEOFMP2TILE;
+
+    if(endof_mp2 < pos + sizeof(u32))
+	return false;
+
+    fd.seekg(pos, std::ios_base::beg);
+    fd.read(reinterpret_cast<char *>(&addons), sizeof(u32));
+    SwapLE32(addons);
+
+    if(! fd.good() || addons > endof_mp2 / SIZEOFMP2ADDON)
+	return false;
+
+    // addons, castles, resources, unknown byte, uniq
+    pos += sizeof(u32) + addons * SIZEOFMP2ADDON + (72 * 3) + (144 * 3) + 1;
+
+    return pos + sizeof(u32) <= endof_mp2;
+}
+
+/* load maps: the pre-parsed world from the maps cache, or parse mp2 */
 void World::LoadMaps(const std::string &filename)
+{
+    AGG::Cache::PreloadObject(TIL::GROUND32);
+
+    // the debug hero is not in the cache
+    const u32 key = Settings::Get().UseMapsCache() && ! IS_DEVEL() ? Game::MapsCacheKey(filename) : 0;
+
+    if(key && Game::LoadMapsCache(filename, key))
+    {
+	DEBUG(DBG_GAME, DBG_INFO, "maps cache: " << filename);
+	return;
+    }
+
+    if(! ReadMaps(filename))
+    {
+	DEBUG(DBG_GAME|DBG_ENGINE, DBG_WARN, "incorrect maps " << filename);
+	Error::Except(__FUNCTION__, "load maps");
+	return;
+    }
+
+    if(key && ! Game::SaveMapsCache(filename, key))
+	DEBUG(DBG_GAME, DBG_WARN, "maps cache: " << filename << ", write: error");
+}
+
+bool World::ReadMaps(const std::string &filename)
 {
     Reset();
     Defaults();
@@ -256,11 +418,9 @@ void World::LoadMaps(const std::string &filename)
     if(!fd.is_open())
     {
 	 DEBUG(DBG_GAME|DBG_ENGINE, DBG_WARN, "file not found " << filename.c_str());
-	 Error::Except(__FUNCTION__, "load maps");
+	 return false;
     }
 
-    AGG::Cache::PreloadObject(TIL::GROUND32);
-
     u8   byte8;
     u16  byte16;
     u32  byte32;
@@ -271,6 +431,9 @@ void World::LoadMaps(const std::string &filename)
     fd.seekg(0, std::ios_base::end);
     const u32 endof_mp2 = fd.tellg();
 
+    if(! CheckMP2(fd, endof_mp2))
+	return false;
+
     // read uniq
     fd.seekg(endof_mp2 - sizeof(u32), std::ios_base::beg);
     fd.read(reinterpret_cast<char *>(&GameStatic::uniq), sizeof(u32));
@@ -354,6 +517,7 @@ void World::LoadMaps(const std::string &filename)
     fd.seekg(MP2OFFSETDATA, std::ios_base::beg);
 
     vec_tiles.resize(width * height);
+    fog_planes.Reset(width, height);
 
     // read all tiles
     for(MapsTiles::iterator
@@ -586,10 +750,16 @@ void World::LoadMaps(const std::string &filename)
 	//if(endof_mp2 < fd.tellg()) Error::Except(__FUNCTION__, "read maps: out of range.");
 
 	// size block
-	u16 sizeblock;
+	u16 sizeblock = 0;
 	fd.read(reinterpret_cast<char *>(&sizeblock), sizeof(u16));
 	SwapLE16(sizeblock);
 
+	if(! fd.good())
+	{
+	    DEBUG(DBG_GAME, DBG_WARN, "final blocks: " << ii << " of " << countblock << ", out of range");
+	    break;
+	}
+
 	u8 *pblock = new u8[sizeblock];
 
 	// read block
@@ -1000,7 +1170,16 @@ void World::LoadMaps(const std::string &filename)
 	}
     }
 
+    ComputeProtection();
+    ComputeMoveCosts();
+    ComputeTeleports();
+    ComputeWeekObjects();
+    ComputeCastlesIndex();
+    ComputeHeroesIndex();
+
     DEBUG(DBG_GAME, DBG_INFO, "end load");
+
+    return true;
 }
 
 Kingdoms & World::GetKingdoms(void)
@@ -1022,12 +1201,23 @@ const Kingdom & World::GetKingdom(u8 color) const
 /* get castle from index maps */
 Castle* World::GetCastle(s32 maps_index)
 {
-    return vec_castles.Get(maps_index);
+    return vec_castlesindex.size() == vec_tiles.size() && Maps::isValidAbsIndex(maps_index) ?
+	vec_castlesindex[maps_index] : vec_castles.Get(maps_index);
 }
 
 const Castle* World::GetCastle(s32 maps_index) const
 {
-    return vec_castles.Get(maps_index);
+    return vec_castlesindex.size() == vec_tiles.size() && Maps::isValidAbsIndex(maps_index) ?
+	vec_castlesindex[maps_index] : vec_castles.Get(maps_index);
+}
+
+void World::AddCastle(Castle* castle)
+{
+    if(castle)
+    {
+	vec_castles.push_back(castle);
+	if(vec_castlesindex.size() == vec_tiles.size()) ComputeCastlesIndex();
+    }
 }
 
 Heroes* World::GetHeroes(Heroes::heroes_t id)
@@ -1043,17 +1233,72 @@ const Heroes* World::GetHeroes(Heroes::heroes_t id) const
 /* get heroes from index maps */
 Heroes* World::GetHeroes(s32 maps_index)
 {
-    return vec_heroes.Get(maps_index);
+    return vec_heroesindex.size() == vec_tiles.size() && Maps::isValidAbsIndex(maps_index) ?
+	vec_heroesindex[maps_index] : vec_heroes.Get(maps_index);
 }
 
 const Heroes* World::GetHeroes(s32 maps_index) const
 {
-    return vec_heroes.Get(maps_index);
+    return vec_heroesindex.size() == vec_tiles.size() && Maps::isValidAbsIndex(maps_index) ?
+	vec_heroesindex[maps_index] : vec_heroes.Get(maps_index);
 }
 
 CastleHeroes World::GetHeroes(const Castle & castle) const
 {
-    return CastleHeroes(vec_heroes.GetGuest(castle), vec_heroes.GetGuard(castle));
+    if(vec_heroesindex.size() != vec_tiles.size())
+	return CastleHeroes(vec_heroes.GetGuest(castle), vec_heroes.GetGuard(castle));
+
+    // guest on the castle center, guardian above
+    const Point & center = castle.GetCenter();
+    Heroes* guest = vec_heroesindex[Maps::GetIndexFromAbsPoint(center)];
+    Heroes* guard = NULL;
+
+    if(guest && guest->Modes(Heroes::GUARDIAN)) guest = NULL;
+
+    if(Settings::Get().ExtCastleAllowGuardians() &&
+	Maps::isValidAbsPoint(center.x, center.y - 1))
+    {
+	guard = vec_heroesindex[Maps::GetIndexFromAbsPoint(center.x, center.y - 1)];
+	if(guard && !guard->Modes(Heroes::GUARDIAN)) guard = NULL;
+    }
+
+    return CastleHeroes(guest, guard);
+}
+
+void World::ComputeCastlesIndex(void)
+{
+    vec_castlesindex.assign(vec_tiles.size(), NULL);
+
+    // castle footprint: 5x4 tiles above the center, see Castle::isPosition
+    for(AllCastles::const_iterator
+	it = vec_castles.begin(); it != vec_castles.end(); ++it)
+    {
+	const Point & center = (*it)->GetCenter();
+
+	for(s16 yy = center.y - 3; yy <= center.y; ++yy)
+	    for(s16 xx = center.x - 2; xx <= center.x + 2; ++xx)
+		if(Maps::isValidAbsPoint(xx, yy) && (*it)->isPosition(Point(xx, yy)))
+		    vec_castlesindex[Maps::GetIndexFromAbsPoint(xx, yy)] = *it;
+    }
+}
+
+void World::ComputeHeroesIndex(void)
+{
+    vec_heroesindex.assign(vec_tiles.size(), NULL);
+
+    // reverse: the first hero by id wins, as VecHeroes::Get
+    for(AllHeroes::const_reverse_iterator
+	it = vec_heroes.rbegin(); it != vec_heroes.rend(); ++it)
+    {
+	const s32 index = (*it)->GetIndex();
+	if(Maps::isValidAbsIndex(index)) vec_heroesindex[index] = *it;
+    }
+}
+
+void World::UpdateHeroesIndex(s32 index)
+{
+    if(vec_heroesindex.size() == vec_tiles.size() && Maps::isValidAbsIndex(index))
+	vec_heroesindex[index] = vec_heroes.Get(index);
 }
 
 /* new day */
@@ -1101,10 +1346,25 @@ void World::NewWeek(void)
     if(1 < week)
     {
 	// update week object
-	for(MapsTiles::iterator
-	    it = vec_tiles.begin(); it != vec_tiles.end(); ++it)
-	    if(MP2::isWeekLife((*it).GetObject(false)) ||
-		MP2::OBJ_MONSTER == (*it).GetObject()) (*it).QuantityUpdate();
+	for(std::set<s32>::iterator
+	    it = set_weekobjects.begin(); it != set_weekobjects.end();)
+	{
+	    Maps::Tiles & tile = vec_tiles[*it];
+
+	    if(MP2::isWeekLife(tile.GetObject(false)) ||
+		MP2::OBJ_MONSTER == tile.GetObject())
+	    {
+		tile.QuantityUpdate();
+		AI::WorldObjectChanged(tile.GetIndex(), Color::ALL);
+		++it;
+	    }
+	    else
+	    // keep under the heroes
+	    if(MP2::OBJ_HEROES != tile.GetObject())
+		set_weekobjects.erase(it++);
+	    else
+		++it;
+	}
 
 	// update gray towns
         for(AllCastles::iterator
@@ -1137,13 +1397,25 @@ void World::NewMonth(void)
 	if((*it)->GetColor() == Color::NONE) (*it)->ActionNewMonth();
 }
 
+/* exclude the square around center, see Maps::GetAroundIndexes */
+void MonthOfMonstersExclude(std::vector<u8> & excld, const s32 & center, u16 dist)
+{
+    const Point cp = Maps::GetPoint(center);
+
+    for(s16 yy = std::max(0, cp.y - dist); yy <= std::min(world.h() - 1, cp.y + dist); ++yy)
+	for(s16 xx = std::max(0, cp.x - dist); xx <= std::min(world.w() - 1, cp.x + dist); ++xx)
+	    if(xx != cp.x || yy != cp.y) excld[yy * world.w() + xx] = 1;
+}
+
 void World::MonthOfMonstersAction(const Monster & mons)
 {
     if(mons.isValid())
     {
-	MapsIndexes tiles, excld;
+	MapsIndexes tiles;
 	tiles.reserve(vec_tiles.size() / 2);
-	excld.reserve(vec_tiles.size() / 2);
+
+	// free tiles sampler: excluded areas by tiles mask
+	std::vector<u8> excld(vec_tiles.size(), 0);
 
 	const u16 dist = 2;
 	const u8 objs[] = { MP2::OBJ_MONSTER, MP2::OBJ_HEROES, MP2::OBJ_CASTLE, MP2::OBJN_CASTLE, 0 };
@@ -1154,10 +1426,7 @@ void World::MonthOfMonstersAction(const Monster & mons)
 
 	    for(MapsIndexes::const_iterator
 		it = objv.begin(); it != objv.end(); ++it)
-	    {
-		const MapsIndexes & obja = Maps::GetAroundIndexes(*it, dist);
-		excld.insert(excld.end(), obja.begin(), obja.end());
-	    }
+		MonthOfMonstersExclude(excld, *it, dist);
 	}
 
 	// create valid points
@@ -1169,11 +1438,10 @@ void World::MonthOfMonstersAction(const Monster & mons)
 	    if(! tile.isWater() &&
 		MP2::OBJ_ZERO == tile.GetObject() &&
 		tile.isPassable(NULL, Direction::CENTER, true) &&
-		excld.end() == std::find(excld.begin(), excld.end(), tile.GetIndex()))
+		! excld[tile.GetIndex()])
 	    {
 		tiles.push_back(tile.GetIndex());
-		const MapsIndexes & obja = Maps::GetAroundIndexes(tile.GetIndex(), dist);
-		excld.insert(excld.end(), obja.begin(), obja.end());
+		MonthOfMonstersExclude(excld, tile.GetIndex(), dist);
 	    }
 	}
 
@@ -1192,6 +1460,15 @@ void World::Reset(void)
 {
     // maps tiles
     vec_tiles.clear();
+    vec_protection.clear();
+    vec_movecosts.clear();
+    map_teleports.clear();
+    map_whirlpools.clear();
+    set_weekobjects.clear();
+    vec_castlesindex.clear();
+    vec_heroesindex.clear();
+    route_hierarchy.Reset();
+    fog_planes.Reset(0, 0);
 
     // kingdoms
     vec_kingdoms.clear();
@@ -1217,6 +1494,7 @@ void World::Reset(void)
     // extra
     map_sign.clear();
     map_captureobj.clear();
+    map_captureobj.Recount();
 
     ultimate_artifact.Reset();
 
@@ -1242,33 +1520,31 @@ const std::string & World::GetRumors(void)
     return *Rand::Get(vec_rumors);
 }
 
-bool TeleportCheckType(s32 index, u8 type)
+bool TeleportCheckGround(s32 index, bool water)
 {
-    return world.GetTiles(index).QuantityTeleportType() == type;
+    return world.GetTiles(index).isWater() == water;
 }
 
-bool TeleportCheckGround(s32 index, bool water)
+bool WhirlpoolCheckFree(s32 index)
 {
-    return world.GetTiles(index).isWater() == water;
+    // skip heroes
+    return MP2::OBJ_WHIRLPOOL == world.GetTiles(index).GetObject();
 }
 
 /* return random teleport destination */
 s32 World::NextTeleport(const s32 index, bool onwater) const
 {
-    MapsIndexes vec_teleports = Maps::GetObjectPositions(MP2::OBJ_STONELIGHTS, true);
+    std::map<u8, MapsIndexes>::const_iterator it = map_teleports.find(GetTiles(index).QuantityTeleportType());
 
-    if(2 > vec_teleports.size())
+    if(it == map_teleports.end() || 2 > (*it).second.size())
     {
 	DEBUG(DBG_GAME, DBG_WARN, "is empty");
 	return index;
     }
 
+    MapsIndexes vec_teleports = (*it).second;
     MapsIndexes::iterator itend = vec_teleports.end();
 
-    // remove if not type
-    itend = std::remove_if(vec_teleports.begin(), itend,
-		    std::not1(std::bind2nd(std::ptr_fun(&TeleportCheckType), GetTiles(index).QuantityTeleportType())));
-
     // remove if index
     itend = std::remove(vec_teleports.begin(), itend, index);
 
@@ -1286,45 +1562,77 @@ s32 World::NextTeleport(const s32 index, bool onwater) const
 /* return random whirlpools destination */
 s32 World::NextWhirlpool(const s32 index)
 {
-    MapsIndexes whilrpools = Maps::GetObjectPositions(MP2::OBJ_WHIRLPOOL, false);
-
-    std::map<s32, MapsIndexes> uniq_whirlpools;
+    const Maps::TilesAddon* addon = GetTiles(index).FindObjectConst(MP2::OBJ_WHIRLPOOL);
+    std::vector<u32> uniqs;
+    uniqs.reserve(map_whirlpools.size());
 
-    for(MapsIndexes::const_iterator
-	it = whilrpools.begin(); it != whilrpools.end(); ++it)
+    for(std::map<u32, MapsIndexes>::const_iterator
+	it = map_whirlpools.begin(); it != map_whirlpools.end(); ++it)
     {
-    	const Maps::TilesAddon* addon = GetTiles(*it).FindObjectConst(MP2::OBJ_WHIRLPOOL);
-	if(addon) uniq_whirlpools[addon->uniq].push_back(*it);
+	const MapsIndexes & group = (*it).second;
+
+	if(group.end() != std::find_if(group.begin(), group.end(), WhirlpoolCheckFree) &&
+	    (! addon || (*it).first != addon->uniq))
+	    uniqs.push_back((*it).first);
     }
-    whilrpools.clear();
 
-    if(2 > uniq_whirlpools.size())
+    if(uniqs.empty())
     {
 	DEBUG(DBG_GAME , DBG_WARN, "is empty");
 	return index;
     }
 
-    const Maps::TilesAddon* addon = GetTiles(index).FindObjectConst(MP2::OBJ_WHIRLPOOL);
-    MapsIndexes uniqs;
-    uniqs.reserve(uniq_whirlpools.size());
+    const MapsIndexes & group = map_whirlpools[*Rand::Get(uniqs)];
+    MapsIndexes dest;
+    dest.reserve(group.size());
 
-    if(addon)
-    {
-	for(std::map<s32, MapsIndexes>::const_iterator
-	    it = uniq_whirlpools.begin(); it != uniq_whirlpools.end(); ++it)
-	{
-	    const u32 & uniq = (*it).first;
-	    if(uniq == addon->uniq) continue;
-	    uniqs.push_back(uniq);
-	}
-    }
+    std::remove_copy_if(group.begin(), group.end(), std::back_inserter(dest),
+		    std::not1(std::ptr_fun(&WhirlpoolCheckFree)));
 
-    MapsIndexes & dest = uniq_whirlpools[*Rand::Get(uniqs)];
-    uniqs.clear();
+    return dest.size() ? *Rand::Get(dest) : index;
+}
 
-    if(dest.empty()) DEBUG(DBG_GAME, DBG_WARN, "is full");
+void World::ComputeWeekObjects(void)
+{
+    set_weekobjects.clear();
 
-    return dest.size() ? *Rand::Get(dest) : index;
+    for(MapsTiles::const_iterator
+	it = vec_tiles.begin(); it != vec_tiles.end(); ++it)
+	if(MP2::isWeekLife((*it).GetObject(false)) ||
+	    MP2::OBJ_MONSTER == (*it).GetObject())
+	    set_weekobjects.insert((*it).GetIndex());
+}
+
+void World::UpdateWeekObject(s32 index)
+{
+    // new objects only, old are removed at the new week
+    const Maps::Tiles & tile = GetTiles(index);
+
+    if(MP2::isWeekLife(tile.GetObject()) || MP2::OBJ_MONSTER == tile.GetObject())
+	set_weekobjects.insert(index);
+}
+
+void World::ComputeTeleports(void)
+{
+    map_teleports.clear();
+    map_whirlpools.clear();
+
+    const MapsIndexes & teleports = Maps::GetObjectPositions(MP2::OBJ_STONELIGHTS, true);
+
+    for(MapsIndexes::const_iterator
+	it = teleports.begin(); it != teleports.end(); ++it)
+	map_teleports[GetTiles(*it).QuantityTeleportType()].push_back(*it);
+
+    const MapsIndexes & whirlpools = Maps::GetObjectPositions(MP2::OBJ_WHIRLPOOL, true);
+
+    for(MapsIndexes::const_iterator
+	it = whirlpools.begin(); it != whirlpools.end(); ++it)
+    {
+	const Maps::TilesAddon* addon = GetTiles(*it).FindObjectConst(MP2::OBJ_WHIRLPOOL);
+	if(addon) map_whirlpools[addon->uniq].push_back(*it);
+    }
+
+    DEBUG(DBG_GAME, DBG_INFO, "teleports: " << teleports.size() << ", whirlpools: " << whirlpools.size());
 }
 
 /* return message from sign */
@@ -1358,6 +1666,8 @@ void World::CaptureObject(const s32 & index, u8 color)
     const MP2::object_t obj = GetTiles(index).GetObject(false);
 
     map_captureobj.Set(index, obj, color);
+    UpdateRouteHierarchy(index);
+    AI::WorldObjectChanged(index, Color::ALL);
 
     if(MP2::OBJ_CASTLE == obj)
     {
@@ -1428,6 +1738,73 @@ bool World::DiggingForUltimateArtifact(const Point & center)
     return false;
 }
 
+void World::ComputeProtection(void)
+{
+    vec_protection.resize(vec_tiles.size());
+
+    for(s32 index = 0; index < static_cast<s32>(vec_tiles.size()); ++index)
+	vec_protection[index] = Maps::CalculateProtection(index);
+}
+
+u16 World::GetProtection(s32 index) const
+{
+    return vec_protection.empty() ? Maps::CalculateProtection(index) : vec_protection[index];
+}
+
+void World::UpdateProtection(s32 index)
+{
+    if(vec_protection.size() != vec_tiles.size() || ! Maps::isValidAbsIndex(index)) return;
+
+    // tile and its neighbours
+    vec_protection[index] = Maps::CalculateProtection(index);
+
+    for(Direction::vector_t direct = Direction::TOP_LEFT; direct != Direction::CENTER; ++direct)
+	if(Maps::isValidDirection(index, direct))
+    {
+	const s32 around = Maps::GetDirectionIndex(index, direct);
+	vec_protection[around] = Maps::CalculateProtection(around);
+    }
+}
+
+void World::ComputeMoveCosts(void)
+{
+    vec_movecosts.resize(vec_tiles.size());
+
+    for(s32 index = 0; index < static_cast<s32>(vec_tiles.size()); ++index)
+	vec_movecosts[index].Set(index);
+}
+
+const Maps::Ground::MoveCost* World::GetMoveCost(s32 index) const
+{
+    return vec_movecosts.empty() ? NULL : &vec_movecosts[index];
+}
+
+void World::UpdateMoveCost(s32 index)
+{
+    if(vec_movecosts.size() == vec_tiles.size() && Maps::isValidAbsIndex(index))
+	vec_movecosts[index].Set(index);
+}
+
+Route::Hierarchy & World::GetRouteHierarchy(void)
+{
+    return route_hierarchy;
+}
+
+void World::UpdateRouteHierarchy(s32 index)
+{
+    route_hierarchy.Invalidate(index);
+}
+
+Maps::FogPlanes & World::GetFog(void)
+{
+    return fog_planes;
+}
+
+const Maps::FogPlanes & World::GetFog(void) const
+{
+    return fog_planes;
+}
+
 void World::ActionForMagellanMaps(u8 color)
 {
     for(MapsTiles::iterator
@@ -1489,7 +1866,11 @@ void World::ResetCapturedObjects(u8 color)
 
 Heroes* World::FromJail(s32 index)
 {
-    return vec_heroes.FromJail(index);
+    if(vec_heroesindex.size() != vec_tiles.size())
+	return vec_heroes.FromJail(index);
+
+    Heroes* hero = GetHeroes(index);
+    return hero && hero->Modes(Heroes::JAIL) ? hero : NULL;
 }
 
 void World::ActionToEyeMagi(u8 color) const
@@ -1680,36 +2061,55 @@ StreamBase & operator>> (StreamBase & msg, CapturedObject & obj)
     return msg >> obj.objcol >> obj.guardians >> obj.split;
 }
 
+/* the world stream after the tiles: see Game::Save, autosave deltas */
+StreamBase & World::SaveStates(StreamBase & msg) const
+{
+    return msg <<
+	vec_heroes <<
+	vec_castles <<
+	vec_kingdoms <<
+	vec_rumors <<
+	vec_eventsday <<
+	vec_eventsmap <<
+	vec_riddles <<
+	map_sign <<
+	map_captureobj <<
+	ultimate_artifact <<
+	day <<
+	week <<
+	month <<
+	week_current <<
+	week_next <<
+	heroes_cond_wins <<
+	heroes_cond_loss <<
+	fog_planes;
+}
+
 StreamBase & operator<< (StreamBase & msg, const World & w)
 {
     const Size & sz = w;
 
-    return msg << sz <<
-	w.vec_tiles <<
-	w.vec_heroes <<
-	w.vec_castles <<
-	w.vec_kingdoms <<
-	w.vec_rumors <<
-	w.vec_eventsday <<
-	w.vec_eventsmap <<
-	w.vec_riddles <<
-	w.map_sign <<
-	w.map_captureobj <<
-	w.ultimate_artifact <<
-	w.day <<
-	w.week <<
-	w.month <<
-	w.week_current <<
-	w.week_next <<
-	w.heroes_cond_wins <<
-	w.heroes_cond_loss;
+    msg << sz << w.vec_tiles;
+
+    return w.SaveStates(msg);
 }
 
 StreamBase & operator>> (StreamBase & msg, World & w)
 {
     Size & sz = w;
 
-    msg >> sz >>
+    w.vec_protection.clear();
+    w.vec_movecosts.clear();
+    w.vec_castlesindex.clear();
+    w.vec_heroesindex.clear();
+    w.route_hierarchy.Reset();
+
+    msg >> sz;
+
+    // old format: fog colors from tiles
+    w.fog_planes.Reset(sz.w, sz.h);
+
+    msg >>
 	w.vec_tiles >>
 	w.vec_heroes >>
 	w.vec_castles >>
@@ -1729,10 +2129,23 @@ StreamBase & operator>> (StreamBase & msg, World & w)
 	w.heroes_cond_wins >>
 	w.heroes_cond_loss;
 
+    if(FORMAT_VERSION_2900 <= Game::GetLoadVersion())
+	msg >> w.fog_planes;
+
+    // captured objects counters: after the tiles
+    w.map_captureobj.Recount();
+
     // update tile passable
     std::for_each(w.vec_tiles.begin(), w.vec_tiles.end(),
         std::mem_fun_ref(&Maps::Tiles::UpdatePassable));
 
+    w.ComputeProtection();
+    w.ComputeMoveCosts();
+    w.ComputeTeleports();
+    w.ComputeWeekObjects();
+    w.ComputeCastlesIndex();
+    w.ComputeHeroesIndex();
+
     // heroes postfix
     std::for_each(w.vec_heroes.begin(), w.vec_heroes.end(),
 	std::mem_fun(&Heroes::RescanPathPassable));
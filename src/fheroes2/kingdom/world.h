@@ -24,6 +24,7 @@
 
 #include <vector>
 #include <map>
+#include <set>
 #include <string>
 #include "gamedefs.h"
 #include "maps.h"
@@ -35,6 +36,8 @@
 #include "castle_heroes.h"
 #include "gameevent.h"
 #include "artifact_ultimate.h"
+#include "route_hierarchy.h"
+#include "maps_fog.h"
 
 class Heroes;
 class Castle;
@@ -70,10 +73,13 @@ struct CapturedObject
 
 struct CapturedObjects : std::map<s32, CapturedObject>
 {
+    CapturedObjects();
+
     void Set(const s32 &, u8, u8);
     void SetColor(const s32 &, u8);
     void ClearFog(u8);
     void ResetColor(u8);
+    void Recount(void);
 
     CapturedObject & Get(const s32 &);
     Funds TributeCapturedObject(u8 col, u8 obj);
@@ -81,6 +87,15 @@ struct CapturedObjects : std::map<s32, CapturedObject>
     u16	 GetCount(u8, u8) const;
     u16	 GetCountMines(u8, u8) const;
     u8   GetColor(const s32 &) const;
+
+private:
+    void Count(const s32 &, const ObjectColor &, s8);
+    u16  ScanCount(u8, u8) const;
+    u16  ScanCountMines(u8, u8) const;
+
+    // counters by color: kingdoms, none, unused
+    u16	 objects[0x100][KINGDOMMAX + 2];
+    u16	 mines[5][KINGDOMMAX + 2]; // ore, sulfur, crystal, gems, gold
 };
 
 class World : protected Size
@@ -89,6 +104,7 @@ public:
     ~World(){ Reset(); }
 
     void LoadMaps(const std::string &filename);
+    bool ReadMaps(const std::string &filename);
     void NewMaps(const u16 sw, const u16 sh);
 
     static World & Get(void);
@@ -113,6 +129,7 @@ public:
 
     const Castle* GetCastle(s32 maps_index) const;
     Castle* GetCastle(s32 maps_index);
+    void AddCastle(Castle*);
 
     const Heroes* GetHeroes(Heroes::heroes_t) const;
     const Heroes* GetHeroes(s32 maps_index) const;
@@ -163,6 +180,21 @@ public:
     u16 CountObeliskOnMaps(void);
 
     void ClearFog(u8 color);
+    Maps::FogPlanes & GetFog(void);
+    const Maps::FogPlanes & GetFog(void) const;
+
+    u16  GetProtection(s32 index) const;
+    void UpdateProtection(s32 index);
+
+    const Maps::Ground::MoveCost* GetMoveCost(s32 index) const;
+    void UpdateMoveCost(s32 index);
+
+    void UpdateWeekObject(s32 index);
+
+    void UpdateHeroesIndex(s32 index);
+
+    Route::Hierarchy & GetRouteHierarchy(void);
+    void UpdateRouteHierarchy(s32 index);
 
     u16  CheckKingdomWins(const Kingdom &) const;
     bool KingdomIsWins(const Kingdom &, u16 wins) const;
@@ -179,11 +211,19 @@ public:
 
     static u32 GetUniq(void);
 
+    StreamBase & SaveStates(StreamBase &) const;
+
 private:
     World() : Size(0, 0), width(Size::w), height(Size::h) {};
     void Defaults(void);
     void Reset(void);
     void MonthOfMonstersAction(const Monster &);
+    void ComputeProtection(void);
+    void ComputeMoveCosts(void);
+    void ComputeTeleports(void);
+    void ComputeWeekObjects(void);
+    void ComputeCastlesIndex(void);
+    void ComputeHeroesIndex(void);
 
 private:
     friend class Radar;
@@ -206,6 +246,29 @@ private:
 
     UltimateArtifact			ultimate_artifact;
 
+    // monster zone of control: see Maps::CalculateProtection
+    std::vector<u16>			vec_protection;
+
+    // movement cost grid: see Maps::Ground::GetPenalty
+    std::vector<Maps::Ground::MoveCost>	vec_movecosts;
+
+    // stone lights by teleport type, whirlpools by addon uniq
+    std::map<u8, MapsIndexes>		map_teleports;
+    std::map<u32, MapsIndexes>		map_whirlpools;
+
+    // castles (with the footprint) and heroes by maps index
+    std::vector<Castle*>		vec_castlesindex;
+    std::vector<Heroes*>		vec_heroesindex;
+
+    // week life and monster tiles: see World::NewWeek
+    std::set<s32>			set_weekobjects;
+
+    // clusters for long routes: see Route::Hierarchy
+    Route::Hierarchy			route_hierarchy;
+
+    // fog of war by kingdoms: see Maps::FogPlanes
+    Maps::FogPlanes			fog_planes;
+
     u16 & width;
     u16 & height;
 
@@ -47,7 +47,47 @@ const char* Maps::Ground::String(u16 ground)
     return str_ground[8];
 }
 
+#define DIRECTION_DIAGONAL (Direction::TOP_RIGHT | Direction::BOTTOM_RIGHT | Direction::BOTTOM_LEFT | Direction::TOP_LEFT)
+
 u16 Maps::Ground::GetPenalty(const s32 & index, Direction::vector_t direct, u8 level)
+{
+    const MoveCost* cost = world.GetMoveCost(index);
+
+    return cost ? cost->Get(direct, level) : CalculatePenalty(index, direct, level);
+}
+
+void Maps::Ground::MoveCost::Set(const s32 & index)
+{
+    const Maps::Tiles & tile = world.GetTiles(index);
+
+    road = 0;
+
+    for(Direction::vector_t direct = Direction::TOP_LEFT; ; ++direct)
+    {
+	if(tile.isRoad(direct)) road |= direct;
+	if(Direction::CENTER == direct) break;
+    }
+
+    for(u8 level = Skill::Level::NONE; level <= Skill::Level::EXPERT; ++level)
+    {
+	// without roads
+	const u16 straight = CalculatePenalty(index, Direction::UNKNOWN, level);
+
+	cost[level][0] = straight;
+	cost[level][1] = straight + straight * 55 / 100;
+    }
+}
+
+u16 Maps::Ground::MoveCost::Get(Direction::vector_t direct, u8 level) const
+{
+    if(road & direct)
+	// road priority: need small value
+	return 59;
+
+    return cost[Skill::Level::EXPERT < level ? Skill::Level::EXPERT : level][direct & DIRECTION_DIAGONAL ? 1 : 0];
+}
+
+u16 Maps::Ground::CalculatePenalty(const s32 & index, Direction::vector_t direct, u8 level)
 {
     const Maps::Tiles & tile = world.GetTiles(index);
 
@@ -100,7 +140,7 @@ u16 Maps::Ground::GetPenalty(const s32 & index, Direction::vector_t direct, u8 l
 	default: break;
     }
 
-    if(direct & (Direction::TOP_RIGHT | Direction::BOTTOM_RIGHT | Direction::BOTTOM_LEFT | Direction::TOP_LEFT))
+    if(direct & DIRECTION_DIAGONAL)
 	result += result * 55 / 100;
 
     return result;
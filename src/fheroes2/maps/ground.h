@@ -49,6 +49,19 @@ namespace Maps
 
         const char* String(u16);
         u16 GetPenalty(const s32 &, Direction::vector_t, u8 pathfinding);
+        u16 CalculatePenalty(const s32 &, Direction::vector_t, u8 pathfinding);
+
+        // per tile move cost: roads and ground penalty for each pathfinding level
+        struct MoveCost
+        {
+            MoveCost() : road(0) {}
+
+            void Set(const s32 &);
+            u16  Get(Direction::vector_t, u8 pathfinding) const;
+
+            u16 road;		// road directions
+            u16 cost[4][2];	// pathfinding level: straight, diagonal
+        };
     }
 }
 
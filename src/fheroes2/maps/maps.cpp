@@ -29,6 +29,7 @@
 #include "kingdom.h"
 #include "difficulty.h"
 #include "maps_tiles.h"
+#include "ai.h"
 
 struct ComparsionDistance
 {
@@ -293,7 +294,6 @@ void Maps::ClearFog(const s32 & index, u8 scoute, u8 color)
 {
     if(0 != scoute && isValidAbsIndex(index))
     {
-	const Point center = GetPoint(index);
 	const Settings & conf = Settings::Get();
 
 	// AI advantage
@@ -311,11 +311,18 @@ void Maps::ClearFog(const s32 & index, u8 scoute, u8 color)
 
 	u8 colors = conf.ExtUnionsAllowViewMaps() ? Players::GetPlayerFriends(color) : color;
 
-	for(s16 y = center.y - scoute; y <= center.y + scoute; ++y)
-    	    for(s16 x = center.x - scoute; x <= center.x + scoute; ++x)
-        	if(isValidAbsPoint(x, y) &&
-		    (scoute + scoute / 2) >= std::abs(x - center.x) + std::abs(y - center.y))
-            	    world.GetTiles(GetIndexFromAbsPoint(x, y)).ClearFog(colors);
+	// reveal the diamond by the planes words, update caches for the new tiles only
+	static FogPlanes::Changes changes;
+	changes.clear();
+
+	world.GetFog().Reveal(index, scoute, colors, changes);
+
+	for(FogPlanes::Changes::const_iterator
+	    it = changes.begin(); it != changes.end(); ++it)
+	{
+	    AI::WorldObjectChanged((*it).first, (*it).second);
+	    world.UpdateRouteHierarchy((*it).first);
+	}
     }
 }
 
@@ -412,24 +419,45 @@ bool Maps::IsNearTiles(const s32 & index1, const s32 & index2)
 
 bool Maps::TileIsUnderProtection(const s32 & center)
 {
-    return MP2::OBJ_MONSTER == world.GetTiles(center).GetObject() ? true :
-	    GetTilesUnderProtection(center).size();
+    return world.GetProtection(center);
 }
 
 Maps::Indexes Maps::GetTilesUnderProtection(const s32 & center)
 {
-    Indexes indexes = Maps::ScanAroundObject(center, MP2::OBJ_MONSTER);
+    Indexes indexes;
+    const u16 protection = world.GetProtection(center);
 
-    indexes.resize(std::distance(indexes.begin(),
-	    std::remove_if(indexes.begin(), indexes.end(),
-		std::not1(std::bind1st(std::ptr_fun(&MapsTileIsUnderProtection), center)))));
+    if(protection)
+    {
+	indexes.reserve(9);
 
-    if(MP2::OBJ_MONSTER == world.GetTiles(center).GetObject())
-	indexes.push_back(center);
+	for(Direction::vector_t direct = Direction::TOP_LEFT; direct != Direction::CENTER; ++direct)
+	    if(protection & direct) indexes.push_back(GetDirectionIndex(center, direct));
+
+	if(protection & Direction::CENTER)
+	    indexes.push_back(center);
+    }
 
     return indexes;
 }
 
+/* directions of the guarding monsters, center: monster tile */
+u16 Maps::CalculateProtection(const s32 & center)
+{
+    u16 res = MP2::OBJ_MONSTER == world.GetTiles(center).GetObject() ? Direction::CENTER : 0;
+
+    for(Direction::vector_t direct = Direction::TOP_LEFT; direct != Direction::CENTER; ++direct)
+	if(isValidDirection(center, direct))
+    {
+	const s32 index = GetDirectionIndex(center, direct);
+
+	if(TileIsObject(index, MP2::OBJ_MONSTER) &&
+	    MapsTileIsUnderProtection(center, index)) res |= direct;
+    }
+
+    return res;
+}
+
 u16 Maps::GetApproximateDistance(const s32 & index1, const s32 & index2)
 {
     const Size sz(GetPoint(index1) - GetPoint(index2));
@@ -87,6 +87,7 @@ namespace Maps
 
     Indexes	GetTilesUnderProtection(const s32 &);
     bool	TileIsUnderProtection(const s32 &);
+    u16		CalculateProtection(const s32 &);
     bool	IsNearTiles(const s32 &, const s32 &);
 
     Indexes GetObjectPositions(u8 obj, bool check_hero);
@@ -0,0 +1,226 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <algorithm>
+#include "color.h"
+#include "serialize.h"
+#include "maps_fog.h"
+
+namespace
+{
+    u32 BitCount(u32 val)
+    {
+	val = val - ((val >> 1) & 0x55555555);
+	val = (val & 0x33333333) + ((val >> 2) & 0x33333333);
+	return (((val + (val >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+    }
+
+    /* bits [first, last] of the word */
+    u32 BitRange(u8 first, u8 last)
+    {
+	const u32 high = 31 > last ? (static_cast<u32>(1) << (last + 1)) - 1 : 0xFFFFFFFF;
+	return high & ~((static_cast<u32>(1) << first) - 1);
+    }
+}
+
+Maps::FogPlanes::FogPlanes() : width(0), height(0), pitch(0)
+{
+}
+
+void Maps::FogPlanes::Reset(u16 w, u16 h)
+{
+    width = w;
+    height = h;
+    pitch = (w + 31) / 32;
+
+    bits.assign(KINGDOMMAX * pitch * height, 0);
+}
+
+bool Maps::FogPlanes::isFog(const s32 & index, u8 colors) const
+{
+    if(index < 0 || index >= width * height) return true;
+
+    const u32 offset = (index / width) * pitch + (index % width) / 32;
+    const u32 bit = static_cast<u32>(1) << ((index % width) % 32);
+
+    // colors may be the union friends: fog for all
+    for(u8 plane = 0; plane < KINGDOMMAX; ++plane)
+	if((colors & (1 << plane)) && (bits[plane * pitch * height + offset] & bit)) return false;
+
+    return true;
+}
+
+u8 Maps::FogPlanes::GetFogColors(const s32 & index) const
+{
+    u8 res = 0;
+
+    for(u8 plane = 0; plane < KINGDOMMAX; ++plane)
+	if(isFog(index, 1 << plane)) res |= (1 << plane);
+
+    return res;
+}
+
+void Maps::FogPlanes::SetFogColors(const s32 & index, u8 colors)
+{
+    if(index < 0 || index >= width * height) return;
+
+    const u32 offset = (index / width) * pitch + (index % width) / 32;
+    const u32 bit = static_cast<u32>(1) << ((index % width) % 32);
+
+    for(u8 plane = 0; plane < KINGDOMMAX; ++plane)
+    {
+	u32 & word = bits[plane * pitch * height + offset];
+
+	if(colors & (1 << plane))
+	    word &= ~bit;
+	else
+	    word |= bit;
+    }
+}
+
+u8 Maps::FogPlanes::Reveal(const s32 & index, u8 colors)
+{
+    const u8 res = GetFogColors(index) & colors;
+    if(res) SetFogColors(index, GetFogColors(index) & ~colors);
+    return res;
+}
+
+const std::vector<s16> & Maps::FogPlanes::GetDiamond(u8 scoute)
+{
+    if(diamonds.size() <= scoute)
+	diamonds.resize(scoute + 1);
+
+    std::vector<s16> & rows = diamonds[scoute];
+
+    if(rows.empty())
+    {
+	rows.resize(2 * scoute + 1);
+
+	// tile in view: dx + dy <= scoute + scoute / 2
+	for(s16 dy = -scoute; dy <= scoute; ++dy)
+	    rows[dy + scoute] = std::min(static_cast<s16>(scoute),
+				static_cast<s16>(scoute + scoute / 2 - std::abs(dy)));
+    }
+
+    return rows;
+}
+
+void Maps::FogPlanes::Reveal(const s32 & center, u8 scoute, u8 colors, Changes & changes)
+{
+    if(center < 0 || center >= width * height) return;
+
+    const std::vector<s16> & rows = GetDiamond(scoute);
+    const s16 cx = center % width;
+    const s16 cy = center / width;
+
+    for(s16 dy = -scoute; dy <= scoute; ++dy)
+    {
+	const s16 y = cy + dy;
+	if(y < 0 || y >= height) continue;
+
+	const s16 x1 = std::max(0, cx - rows[dy + scoute]);
+	const s16 x2 = std::min(width - 1, cx + rows[dy + scoute]);
+
+	for(s16 word = x1 / 32; word <= x2 / 32; ++word)
+	{
+	    const u32 mask = BitRange(std::max(x1, static_cast<s16>(word * 32)) - word * 32,
+				    std::min(x2, static_cast<s16>(word * 32 + 31)) - word * 32);
+	    const u32 offset = y * pitch + word;
+	    u32 revealed[KINGDOMMAX];
+	    u32 any = 0;
+
+	    for(u8 plane = 0; plane < KINGDOMMAX; ++plane)
+	    {
+		revealed[plane] = 0;
+
+		if(colors & (1 << plane))
+		{
+		    u32 & bits_word = bits[plane * pitch * height + offset];
+		    revealed[plane] = mask & ~bits_word;
+		    bits_word |= mask;
+		    any |= revealed[plane];
+		}
+	    }
+
+	    // new tiles in view
+	    for(u8 bit = 0; any; ++bit, any >>= 1) if(any & 1)
+	    {
+		u8 cols = 0;
+
+		for(u8 plane = 0; plane < KINGDOMMAX; ++plane)
+		    if(revealed[plane] & (static_cast<u32>(1) << bit)) cols |= (1 << plane);
+
+		changes.push_back(std::make_pair(y * width + word * 32 + bit, cols));
+	    }
+	}
+    }
+}
+
+u32 Maps::FogPlanes::CountRevealed(u8 color) const
+{
+    const u8 plane = Color::GetIndex(color);
+    u32 res = 0;
+
+    if(plane < KINGDOMMAX)
+    {
+	std::vector<u32>::const_iterator it = bits.begin() + plane * pitch * height;
+	const std::vector<u32>::const_iterator end = it + pitch * height;
+
+	for(; it != end; ++it) if(*it) res += BitCount(*it);
+    }
+
+    return res;
+}
+
+void Maps::FogPlanes::GetRevealed(u8 color, Indexes & result) const
+{
+    const u8 plane = Color::GetIndex(color);
+    if(plane >= KINGDOMMAX) return;
+
+    const u32 start = plane * pitch * height;
+
+    for(u16 y = 0; y < height; ++y)
+	for(u16 word = 0; word < pitch; ++word)
+    {
+	u32 val = bits[start + y * pitch + word];
+
+	for(u8 bit = 0; val; ++bit, val >>= 1)
+	    if(val & 1) result.push_back(y * width + word * 32 + bit);
+    }
+}
+
+StreamBase & Maps::operator<< (StreamBase & msg, const FogPlanes & fog)
+{
+    return msg << fog.width << fog.height << fog.bits;
+}
+
+StreamBase & Maps::operator>> (StreamBase & msg, FogPlanes & fog)
+{
+    msg >> fog.width >> fog.height >> fog.bits;
+    fog.pitch = (fog.width + 31) / 32;
+
+    if(fog.bits.size() != static_cast<size_t>(KINGDOMMAX * fog.pitch * fog.height))
+	fog.bits.assign(KINGDOMMAX * fog.pitch * fog.height, 0);
+
+    return msg;
+}
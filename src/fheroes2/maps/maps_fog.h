@@ -0,0 +1,72 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef H2MAPSFOG_H
+#define H2MAPSFOG_H
+
+#include <vector>
+#include <utility>
+#include "gamedefs.h"
+#include "maps.h"
+
+class StreamBase;
+
+namespace Maps
+{
+    /* fog of war: bit plane by kingdom, one bit by tile (set: revealed), packed by rows */
+    class FogPlanes
+    {
+	public:
+	    typedef std::vector< std::pair<s32, u8> > Changes; // index, colors revealed
+
+	    FogPlanes();
+
+	    void	Reset(u16 width, u16 height);
+
+	    bool	isFog(const s32 &, u8 colors) const;
+	    u8		GetFogColors(const s32 &) const;
+	    void	SetFogColors(const s32 &, u8 colors);
+
+	    u8		Reveal(const s32 &, u8 colors);
+	    void	Reveal(const s32 & center, u8 scoute, u8 colors, Changes &);
+
+	    u32		CountRevealed(u8 color) const;
+	    void	GetRevealed(u8 color, Indexes &) const;
+
+	private:
+	    friend StreamBase & operator<< (StreamBase &, const FogPlanes &);
+	    friend StreamBase & operator>> (StreamBase &, FogPlanes &);
+
+	    const std::vector<s16> & GetDiamond(u8 scoute);
+
+	    u16			width;
+	    u16			height;
+	    u16			pitch;		// words by row
+	    std::vector<u32>	bits;		// planes: BLUE, GREEN, RED, YELLOW, ORANGE, PURPLE
+	    std::vector< std::vector<s16> > diamonds; // by scoute: half width of rows
+    };
+
+    StreamBase & operator<< (StreamBase &, const FogPlanes &);
+    StreamBase & operator>> (StreamBase &, FogPlanes &);
+}
+
+#endif
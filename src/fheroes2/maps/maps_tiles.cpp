@@ -21,6 +21,8 @@
  ***************************************************************************/
 
 #include <list>
+#include <new>
+#include <memory>
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
@@ -29,6 +31,7 @@
 #include "world.h"
 #include "race.h"
 #include "settings.h"
+#include "game.h"
 #include "heroes.h"
 #include "castle.h"
 #include "maps.h"
@@ -51,6 +54,7 @@
 #include "spell.h"
 #include "resource.h"
 #include "maps_tiles.h"
+#include "ai.h"
 
 u8 monster_animation_cicle[] = { 0, 1, 2, 1, 0, 3, 4, 5, 4, 3 };
 
@@ -974,15 +978,201 @@ bool Maps::TilesAddon::ForceLevel2(const TilesAddon & ta)
     return false;
 }
 
+namespace
+{
+    enum { ARENA_CHUNKBITS = 13, ARENA_CHUNKSLOTS = 1 << ARENA_CHUNKBITS, ARENA_GRADES = 12 };
+
+    /* the addons arena: chunks of addons, the blocks of 1, 2, 4 .. MAXSIZE addons
+       are recycled by grade; the chunks do not move, so the blocks do not either */
+    struct AddonsArena
+    {
+	AddonsArena() : last(ARENA_CHUNKSLOTS), used(0) {}
+
+	Maps::TilesAddon* Get(u32 block)
+	{
+	    return chunks[block >> ARENA_CHUNKBITS] + (block & (ARENA_CHUNKSLOTS - 1));
+	}
+
+	u32 Alloc(u8 grade)
+	{
+	    const u32 slots = 1 << (grade - 1);
+	    std::vector<u32> & free = frees[grade];
+	    u32 block = 0;
+
+	    if(free.size())
+	    {
+		block = free.back();
+		free.pop_back();
+	    }
+	    else
+	    {
+		if(last + slots > ARENA_CHUNKSLOTS)
+		{
+		    chunks.push_back(static_cast<Maps::TilesAddon*>(::operator new(ARENA_CHUNKSLOTS * sizeof(Maps::TilesAddon))));
+		    last = 0;
+		}
+
+		block = ((chunks.size() - 1) << ARENA_CHUNKBITS) | last;
+		last += slots;
+	    }
+
+	    used += slots;
+	    return block;
+	}
+
+	void Free(u32 block, u8 grade)
+	{
+	    frees[grade].push_back(block);
+	    used -= 1 << (grade - 1);
+	}
+
+	std::vector<Maps::TilesAddon*> chunks;
+	std::vector<u32>	frees[ARENA_GRADES];
+	u32			last;	// first free slot of the last chunk
+	u32			used;	// slots in the blocks
+    };
+
+    /* not released: the world tiles are destroyed after the local statics */
+    AddonsArena & GetAddonsArena(void)
+    {
+	static AddonsArena* arena = new AddonsArena();
+	return *arena;
+    }
+
+    u8 AddonsGrade(size_t size)
+    {
+	u8 grade = 1;
+	while((1u << (grade - 1)) < size) ++grade;
+	return grade;
+    }
+}
+
 /* Maps::Addons */
+Maps::Addons::Addons() : block(0), count(0), grade(0)
+{
+}
+
+Maps::Addons::Addons(const Addons & addons) : block(0), count(0), grade(0)
+{
+    *this = addons;
+}
+
+Maps::Addons::~Addons()
+{
+    if(grade) GetAddonsArena().Free(block, grade);
+}
+
+Maps::Addons & Maps::Addons::operator= (const Addons & addons)
+{
+    if(this != &addons)
+    {
+	count = 0;
+	Reserve(addons.count);
+	std::uninitialized_copy(addons.begin(), addons.end(), begin());
+	count = addons.count;
+    }
+
+    return *this;
+}
+
+Maps::Addons::iterator Maps::Addons::begin(void)
+{
+    return grade ? GetAddonsArena().Get(block) : NULL;
+}
+
+Maps::Addons::iterator Maps::Addons::end(void)
+{
+    return begin() + count;
+}
+
+Maps::Addons::const_iterator Maps::Addons::begin(void) const
+{
+    return grade ? GetAddonsArena().Get(block) : NULL;
+}
+
+Maps::Addons::const_iterator Maps::Addons::end(void) const
+{
+    return begin() + count;
+}
+
+void Maps::Addons::Reserve(size_t size)
+{
+    if(size <= static_cast<size_t>(grade ? 1 << (grade - 1) : 0))
+	return;
+
+    AddonsArena & arena = GetAddonsArena();
+    const u8 newgrade = AddonsGrade(size);
+    const u32 newblock = arena.Alloc(newgrade);
+
+    if(grade)
+    {
+	std::uninitialized_copy(begin(), end(), arena.Get(newblock));
+	arena.Free(block, grade);
+    }
+
+    block = newblock;
+    grade = newgrade;
+}
+
+void Maps::Addons::clear(void)
+{
+    count = 0;
+}
+
+void Maps::Addons::resize(size_t size)
+{
+    if(size > MAXSIZE) size = MAXSIZE;
+
+    Reserve(size);
+
+    for(iterator it = end(); count < size; ++it, ++count)
+	new (it) TilesAddon();
+
+    count = size;
+}
+
+void Maps::Addons::push_back(const TilesAddon & ta)
+{
+    if(count >= MAXSIZE)
+    {
+	DEBUG(DBG_GAME, DBG_WARN, "addons: " << count << ", out of range");
+	return;
+    }
+
+    // the growth doubles by the grade
+    Reserve(count + 1);
+    new (end()) TilesAddon(ta);
+    ++count;
+}
+
+void Maps::Addons::swap(Addons & addons)
+{
+    std::swap(block, addons.block);
+    std::swap(count, addons.count);
+    std::swap(grade, addons.grade);
+}
+
 void Maps::Addons::Remove(u32 uniq)
 {
-    /*
-    erase(std::remove_if(begin(), end(),
-	    std::bind2nd(std::mem_fun_ref(&Maps::TilesAddon::isUniq), uniq)),
-	    end());
-    */
-    remove_if(std::bind2nd(std::mem_fun_ref(&Maps::TilesAddon::isUniq), uniq));
+    count = std::distance(begin(), std::remove_if(begin(), end(),
+	    std::bind2nd(std::mem_fun_ref(&Maps::TilesAddon::isUniq), uniq)));
+}
+
+void Maps::Addons::Shrink(void)
+{
+    // release the growth reserve
+    if(grade && (0 == count || AddonsGrade(count) < grade))
+	Addons(*this).swap(*this);
+}
+
+u32 Maps::Addons::GetArenaUsed(void)
+{
+    return GetAddonsArena().used * sizeof(TilesAddon);
+}
+
+u32 Maps::Addons::GetArenaReserved(void)
+{
+    return GetAddonsArena().chunks.size() * ARENA_CHUNKSLOTS * sizeof(TilesAddon);
 }
 
 u16 PackTileSpriteIndex(u16 index, u16 shape) /* index max: 0x3FFF, shape value: 0, 1, 2, 3 */
@@ -992,7 +1182,7 @@ u16 PackTileSpriteIndex(u16 index, u16 shape) /* index max: 0x3FFF, shape value:
 
 /* Maps::Tiles */
 Maps::Tiles::Tiles() : pack_maps_index(0), pack_sprite_index(0), tile_passable(DIRECTION_ALL),
-    mp2_object(0), fog_colors(Color::ALL), quantity1(0), quantity2(0)
+    mp2_object(0), quantity1(0), quantity2(0)
 #ifdef WITH_DEBUG
     , passable_disable(0)
 #endif
@@ -1006,7 +1196,6 @@ void Maps::Tiles::Init(s32 index, const MP2::mp2tile_t & mp2)
     tile_passable = DIRECTION_ALL;
     quantity1	= mp2.quantity1;
     quantity2	= mp2.quantity2;
-    fog_colors	= Color::ALL;
 
     SetObject(mp2.generalObject);
 
@@ -1074,12 +1263,20 @@ MP2::object_t Maps::Tiles::GetObject(bool skip_hero  /* true */) const
 
 void Maps::Tiles::SetObject(u8 object)
 {
+    const bool monster = MP2::OBJ_MONSTER == object || MP2::OBJ_MONSTER == mp2_object;
+
     mp2_object = object;
+
+    if(monster) world.UpdateProtection(GetIndex());
+    world.UpdateWeekObject(GetIndex());
+    world.UpdateRouteHierarchy(GetIndex());
+    AI::WorldObjectChanged(GetIndex(), Color::ALL);
 }
 
 void Maps::Tiles::SetTile(const u16 sprite_index, const u8 shape)
 {
     pack_sprite_index = PackTileSpriteIndex(sprite_index, shape);
+    world.UpdateMoveCost(GetIndex());
 }
 
 u16 Maps::Tiles::TileSpriteIndex(void) const
@@ -1146,6 +1343,7 @@ bool Maps::Tiles::isLongObject(u16 direction)
 void Maps::Tiles::UpdatePassable(void)
 {
     tile_passable = DIRECTION_ALL;
+    world.UpdateRouteHierarchy(GetIndex());
 #ifdef WITH_DEBUG
     passable_disable = 0;
 #endif
@@ -1326,6 +1524,9 @@ void Maps::Tiles::AddonsPushLevel1(const TilesAddon & ta)
 	addons_level2.push_back(ta);
     else
     addons_level1.push_back(ta);
+
+    // roads
+    world.UpdateMoveCost(GetIndex());
 }
 
 void Maps::Tiles::AddonsPushLevel2(const MP2::mp2tile_t & mt)
@@ -1350,8 +1551,12 @@ void Maps::Tiles::AddonsPushLevel2(const TilesAddon & ta)
 
 void Maps::Tiles::AddonsSort(void)
 {
-    if(!addons_level1.empty()) addons_level1.sort(TilesAddon::PredicateSortRules1);
-    if(!addons_level2.empty()) addons_level2.sort(TilesAddon::PredicateSortRules2);
+    if(!addons_level1.empty()) std::stable_sort(addons_level1.begin(), addons_level1.end(), TilesAddon::PredicateSortRules1);
+    if(!addons_level2.empty()) std::stable_sort(addons_level2.begin(), addons_level2.end(), TilesAddon::PredicateSortRules2);
+
+    // the maps is loaded: keep addons compact
+    addons_level1.Shrink();
+    addons_level2.Shrink();
 }
 
 Maps::Ground::ground_t Maps::Tiles::GetGround(void) const
@@ -1397,6 +1602,10 @@ void Maps::Tiles::Remove(u32 uniq)
 {
     if(!addons_level1.empty()) addons_level1.Remove(uniq);
     if(!addons_level2.empty()) addons_level2.Remove(uniq);
+
+    // roads
+    world.UpdateMoveCost(GetIndex());
+    world.UpdateRouteHierarchy(GetIndex());
 }
 
 void Maps::Tiles::RedrawTile(Surface & dst) const
@@ -1938,7 +2147,8 @@ bool Maps::Tiles::isPassable(const Heroes & hero) const
 
 bool Maps::Tiles::isPassable(const Heroes* hero, u16 direct, bool skipfog) const
 {
-    if(!skipfog && isFog(Settings::Get().CurrentColor()))
+    // hero fog: the AI plans out of the current turn, see AI::KingdomsPlan
+    if(!skipfog && isFog(hero ? hero->GetColor() : Settings::Get().CurrentColor()))
 	return false;
 
     if(hero && ! isPassable(*hero))
@@ -1956,6 +2166,8 @@ void Maps::Tiles::SetObjectPassable(bool pass)
 		tile_passable |= Direction::TOP_LEFT;
 	    else
 		tile_passable &= ~Direction::TOP_LEFT;
+	    world.UpdateProtection(GetIndex());
+	    world.UpdateRouteHierarchy(GetIndex());
 	    break;
 
 	default:
@@ -2289,6 +2501,7 @@ bool Maps::Tiles::CaptureObjectIsProtection(void) const
 void Maps::Tiles::RemoveObjectSprite(void)
 {
     Maps::TilesAddon *addon = NULL;
+    bool freed = false;
 
     switch(GetObject())
     {
@@ -2302,12 +2515,20 @@ void Maps::Tiles::RemoveObjectSprite(void)
 	case MP2::OBJ_ARTIFACT:
 	case MP2::OBJ_CAMPFIRE:		addon = FindObject(GetObject()); break;
 
-	case MP2::OBJ_JAIL:		RemoveJailSprite(); tile_passable = DIRECTION_ALL; break;
-	case MP2::OBJ_BARRIER:		RemoveBarrierSprite(); tile_passable = DIRECTION_ALL; break;
+	case MP2::OBJ_JAIL:		RemoveJailSprite(); freed = true; break;
+	case MP2::OBJ_BARRIER:		RemoveBarrierSprite(); freed = true; break;
 
 	default: break;
     }
 
+    // the freed tile: monsters around protect it now
+    if(freed)
+    {
+	tile_passable = DIRECTION_ALL;
+	world.UpdateProtection(GetIndex());
+	world.UpdateRouteHierarchy(GetIndex());
+    }
+
     if(addon)
     {
         // remove shadow sprite from left cell
@@ -2518,12 +2739,18 @@ void Maps::Tiles::UpdateTreasureChestSprite(Tiles & tile)
 bool Maps::Tiles::isFog(u8 colors) const
 {
     // colors may be the union friends
-    return (fog_colors & colors) == colors;
+    return world.GetFog().isFog(GetIndex(), colors);
 }
 
 void Maps::Tiles::ClearFog(u8 colors)
 {
-    fog_colors &= ~colors;
+    const u8 revealed = world.GetFog().Reveal(GetIndex(), colors);
+
+    if(revealed)
+    {
+	AI::WorldObjectChanged(GetIndex(), revealed);
+	world.UpdateRouteHierarchy(GetIndex());
+    }
 }
 
 void Maps::Tiles::RedrawFogs(Surface & dst, u8 color) const
@@ -2534,11 +2761,13 @@ void Maps::Tiles::RedrawFogs(Surface & dst, u8 color) const
     // get direction around foga
     u16 around = 0;
 
+    const FogPlanes & fog = world.GetFog();
+
     for(Direction::vector_t direct = Direction::TOP_LEFT; direct != Direction::CENTER; ++direct)
         if(!Maps::isValidDirection(GetIndex(), direct) ||
-           world.GetTiles(Maps::GetDirectionIndex(GetIndex(), direct)).isFog(color)) around |= direct;
+           fog.isFog(Maps::GetDirectionIndex(GetIndex(), direct), color)) around |= direct;
 
-    if(isFog(color)) around |= Direction::CENTER;
+    if(fog.isFog(GetIndex(), color)) around |= Direction::CENTER;
  
     // TIL::CLOF32
     if(DIRECTION_ALL == around)
@@ -2764,6 +2993,38 @@ StreamBase & Maps::operator>> (StreamBase & msg, TilesAddon & ta)
     return msg >> ta.level >> ta.uniq >> ta.object >> ta.index >> ta.tmp;
 }
 
+StreamBase & Maps::operator<< (StreamBase & msg, const Addons & addons)
+{
+    msg << static_cast<u32>(addons.size());
+
+    for(Addons::const_iterator
+	it = addons.begin(); it != addons.end(); ++it)
+	msg << *it;
+
+    return msg;
+}
+
+StreamBase & Maps::operator>> (StreamBase & msg, Addons & addons)
+{
+    u32 size = 0;
+    msg >> size;
+
+    addons.resize(size);
+
+    for(Addons::iterator
+	it = addons.begin(); it != addons.end(); ++it)
+	msg >> *it;
+
+    // out of range: skip
+    for(u32 ii = addons.size(); ii < size; ++ii)
+    {
+	TilesAddon ta;
+	msg >> ta;
+    }
+
+    return msg;
+}
+
 StreamBase & Maps::operator<< (StreamBase & msg, const Tiles & tile)
 {
     return msg <<
@@ -2771,7 +3032,6 @@ StreamBase & Maps::operator<< (StreamBase & msg, const Tiles & tile)
 	tile.pack_sprite_index <<
 	tile.tile_passable <<
 	tile.mp2_object <<
-	tile.fog_colors <<
 	tile.quantity1 <<
 	tile.quantity2 <<
         // addons 1
@@ -2782,12 +3042,21 @@ StreamBase & Maps::operator<< (StreamBase & msg, const Tiles & tile)
 
 StreamBase & Maps::operator>> (StreamBase & msg, Tiles & tile)
 {
-    return msg >>
+    msg >>
 	tile.pack_maps_index >>
 	tile.pack_sprite_index >>
 	tile.tile_passable >>
-	tile.mp2_object >>
-	tile.fog_colors >>
+	tile.mp2_object;
+
+    // fog colors moved to the world fog planes
+    if(FORMAT_VERSION_2900 > Game::GetLoadVersion())
+    {
+	u8 fog_colors = 0;
+	msg >> fog_colors;
+	world.GetFog().SetFogColors(tile.GetIndex(), fog_colors);
+    }
+
+    return msg >>
 	tile.quantity1 >>
 	tile.quantity2 >>
         // addons 1
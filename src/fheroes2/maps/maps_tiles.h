@@ -23,6 +23,7 @@
 #define H2TILES_H
 
 #include <list>
+#include <vector>
 #include <functional>
 #include "ground.h"
 #include "mp2.h"
@@ -120,9 +121,46 @@ namespace Maps
 	u8	tmp;
     };
 
-    struct Addons : public std::list<TilesAddon>
+    /* addons of the tile: one block of the addons arena, the block handle only in the tile */
+    class Addons
     {
-	void Remove(u32 uniq);
+    public:
+	typedef TilesAddon*		iterator;
+	typedef const TilesAddon*	const_iterator;
+
+	enum { MAXSIZE = 0x0400 };
+
+	Addons();
+	Addons(const Addons &);
+	~Addons();
+
+	Addons & operator= (const Addons &);
+
+	iterator	begin(void);
+	iterator	end(void);
+	const_iterator	begin(void) const;
+	const_iterator	end(void) const;
+
+	size_t		size(void) const { return count; }
+	bool		empty(void) const { return 0 == count; }
+
+	void		clear(void);
+	void		resize(size_t);
+	void		push_back(const TilesAddon &);
+	void		swap(Addons &);
+
+	void		Remove(u32 uniq);
+	void		Shrink(void);
+
+	static u32	GetArenaUsed(void);
+	static u32	GetArenaReserved(void);
+
+    private:
+	void		Reserve(size_t);
+
+	u32		block;
+	u16		count;
+	u8		grade;	// capacity: 1 << (grade - 1), 0: without block
     };
 
     class Tiles
@@ -277,7 +315,6 @@ namespace Maps
 
 	u16	tile_passable;
         u8      mp2_object;
-        u8	fog_colors;
 
         u8      quantity1;
         u8      quantity2;
@@ -288,8 +325,10 @@ namespace Maps
     };
 
     StreamBase & operator<< (StreamBase &, const TilesAddon &);
+    StreamBase & operator<< (StreamBase &, const Addons &);
     StreamBase & operator<< (StreamBase &, const Tiles &);
     StreamBase & operator>> (StreamBase &, TilesAddon &);
+    StreamBase & operator>> (StreamBase &, Addons &);
     StreamBase & operator>> (StreamBase &, Tiles &);
 }
 
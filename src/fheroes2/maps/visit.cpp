@@ -20,6 +20,8 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <algorithm>
+#include "serialize.h"
 #include "pairs.h"
 #include "visit.h"
 
@@ -27,3 +29,72 @@ bool Visit::isDayLife(const IndexObject & visit){ return MP2::isDayLife(visit.se
 bool Visit::isWeekLife(const IndexObject & visit){ return MP2::isWeekLife(visit.second); }
 bool Visit::isMonthLife(const IndexObject & visit){ return MP2::isMonthLife(visit.second); }
 bool Visit::isBattleLife(const IndexObject & visit){ return MP2::isBattleLife(visit.second); }
+
+VisitObjects::VisitObjects()
+{
+    clear();
+}
+
+void VisitObjects::clear(void)
+{
+    objects.clear();
+    indexes.clear();
+    std::fill(counts, counts + ARRAY_COUNT(counts), 0);
+}
+
+void VisitObjects::push_front(const IndexObject & visit)
+{
+    objects.push_front(visit);
+    indexes[visit.first] = visit.second;
+    ++counts[visit.second];
+}
+
+void VisitObjects::remove_if(bool (*pred)(const IndexObject &))
+{
+    const size_t size = objects.size();
+
+    objects.remove_if(pred);
+    if(size != objects.size()) Rebuild();
+}
+
+void VisitObjects::Rebuild(void)
+{
+    indexes.clear();
+    std::fill(counts, counts + ARRAY_COUNT(counts), 0);
+
+    // from old to last: the last object by index wins
+    for(std::list<IndexObject>::const_reverse_iterator
+	it = objects.rbegin(); it != objects.rend(); ++it)
+    {
+	indexes[(*it).first] = (*it).second;
+	++counts[(*it).second];
+    }
+}
+
+bool VisitObjects::isVisited(s32 index, u8 object) const
+{
+    std::map<s32, u8>::const_iterator it = indexes.find(index);
+    return it != indexes.end() && (*it).second == object;
+}
+
+bool VisitObjects::isVisited(u8 object) const
+{
+    return counts[object];
+}
+
+u16 VisitObjects::Count(u8 object) const
+{
+    return counts[object];
+}
+
+StreamBase & operator<< (StreamBase & msg, const VisitObjects & visit)
+{
+    return msg << visit.objects;
+}
+
+StreamBase & operator>> (StreamBase & msg, VisitObjects & visit)
+{
+    msg >> visit.objects;
+    visit.Rebuild();
+    return msg;
+}
@@ -23,7 +23,11 @@
 #ifndef H2MAPSVISIT_H
 #define H2MAPSVISIT_H
 
-class IndexObject;
+#include <list>
+#include <map>
+#include "pairs.h"
+
+class StreamBase;
 
 namespace Visit
 {
@@ -35,4 +39,32 @@ namespace Visit
     bool isBattleLife(const IndexObject & visit);
 }
 
+/* visited objects: the list in visit order (last first), indexed by maps index and object */
+class VisitObjects
+{
+public:
+    VisitObjects();
+
+    void	clear(void);
+    void	push_front(const IndexObject &);
+    void	remove_if(bool (*)(const IndexObject &));
+
+    bool	isVisited(s32 index, u8 object) const;
+    bool	isVisited(u8 object) const;
+    u16		Count(u8 object) const;
+
+private:
+    friend StreamBase & operator<< (StreamBase &, const VisitObjects &);
+    friend StreamBase & operator>> (StreamBase &, VisitObjects &);
+
+    void	Rebuild(void);
+
+    std::list<IndexObject>	objects;
+    std::map<s32, u8>		indexes;	// last object by index
+    u16				counts[0x100];	// by object
+};
+
+StreamBase & operator<< (StreamBase &, const VisitObjects &);
+StreamBase & operator>> (StreamBase &, VisitObjects &);
+
 #endif
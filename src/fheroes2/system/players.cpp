@@ -35,7 +35,7 @@ namespace
     Player* _players[KINGDOMMAX + 1] = { NULL };
     u8 human_colors = 0;
 
-    enum { ST_INGAME = 0x2000 };
+    enum { ST_INGAME = 0x2000, ST_RANDRACE = 0x4000 };
 }
 
 void PlayerFocusReset(Player* player)
@@ -50,7 +50,11 @@ void PlayerFixMultiControl(Player* player)
 
 void PlayerFixRandomRace(Player* player)
 {
-    if(player && player->race == Race::RAND) player->race = Race::Rand();
+    if(player && player->race == Race::RAND)
+    {
+	player->race = Race::Rand();
+	player->SetModes(ST_RANDRACE);
+    }
 }
 
 Player::Player(u8 col) : control(CONTROL_NONE), color(col), race(Race::NONE), friends(col), id(World::GetUniq())
@@ -108,6 +112,12 @@ void Player::SetPlay(bool f)
     if(f) SetModes(ST_INGAME); else ResetModes(ST_INGAME);
 }
 
+/* the race before the random roll */
+u8 Player::GetSetupRace(void) const
+{
+    return Modes(ST_RANDRACE) ? static_cast<u8>(Race::RAND) : race;
+}
+
 StreamBase & operator<< (StreamBase & msg, const Focus & focus)
 {
     msg << focus.first;
@@ -64,6 +64,7 @@ public:
 
     void SetControl(u8);
     void SetPlay(bool);
+    u8   GetSetupRace(void) const;
 
     bool isRemote(void) const;
     bool isLocal(void) const;
@@ -65,6 +65,7 @@ const char* StringDebug(int name)
 
 enum
 {
+    GLOBAL_MAPSCACHE         = 0x00000001,
     GLOBAL_PRICELOYALTY      = 0x00000004,
 
     GLOBAL_POCKETPC          = 0x00000010,
@@ -115,6 +116,7 @@ const settings_t settingsGeneral[] =
     { GLOBAL_POCKETPC,    "pocketpc",     },
     { GLOBAL_POCKETPC,    "pocket pc",    },
     { GLOBAL_USESWSURFACE,"use swsurface only",},
+    { GLOBAL_MAPSCACHE,   "maps cache",   },
     { 0, NULL, },
 };
 
@@ -181,6 +183,7 @@ const settings_t settingsFHeroes2[] =
     { Settings::GAME_SHOW_SYSTEM_INFO,		_("game: show system info"),				},
     { Settings::GAME_AUTOSAVE_ON,		_("game: autosave on"),					},
     { Settings::GAME_AUTOSAVE_BEGIN_DAY,	_("game: autosave will be made at the beginning of the day"), },
+    { Settings::GAME_AUTOSAVE_DELTA,		_("game: autosave writes the changes from the last full save"), },
     { Settings::GAME_USE_FADE,			_("game: use fade"),					},
     { Settings::GAME_SHOW_SDL_LOGO,		_("game: show SDL logo"),				},
     { Settings::GAME_EVIL_INTERFACE,		_("game: use evil interface"),				},
@@ -214,7 +217,7 @@ std::string Settings::GetVersion(void)
 Settings::Settings() : debug(DEFAULT_DEBUG), video_mode(0, 0), game_difficulty(Difficulty::NORMAL),
     font_normal("dejavusans.ttf"), font_small("dejavusans.ttf"), force_lang("en"), size_normal(15), size_small(10),
     sound_volume(6), music_volume(6), heroes_speed(DEFAULT_SPEED_DELAY), ai_speed(DEFAULT_SPEED_DELAY), scroll_speed(SCROLL_NORMAL), battle_speed(DEFAULT_SPEED_DELAY),
-    game_type(0), preferably_count_players(0), port(DEFAULT_PORT), memory_limit(0)
+    game_type(0), preferably_count_players(0), port(DEFAULT_PORT), memory_limit(0), route_tolerance(0)
 {
     ExtSetModes(GAME_SHOW_SDL_LOGO);
     ExtSetModes(GAME_AUTOSAVE_ON);
@@ -374,6 +377,14 @@ bool Settings::Read(const std::string & filename)
     entry = config.Find("memory limit");
     if(entry) memory_limit = entry->IntParams();
 
+    // hierarchical pathfinding: route cost tolerance in percent, 0 - off
+    entry = config.Find("route tolerance");
+    if(entry)
+    {
+	route_tolerance = entry->IntParams();
+	if(100 < route_tolerance) route_tolerance = 100;
+    }
+
     // default depth
     entry = config.Find("default depth");
     if(entry) Surface::SetDefaultDepth(entry->IntParams());
@@ -637,6 +648,9 @@ std::string Settings::String(void) const
     if(opt_global.Modes(GLOBAL_POCKETPC))
     os << "pocket pc = on" << std::endl;
 
+    if(opt_global.Modes(GLOBAL_MAPSCACHE))
+    os << "maps cache = on" << std::endl;
+
     return os.str();
 }
 
@@ -842,6 +856,9 @@ u8   Settings::HeroesMoveSpeed(void) const { return heroes_speed; }
 u8   Settings::AIMoveSpeed(void) const { return ai_speed; }
 u8   Settings::BattleSpeed(void) const { return battle_speed; }
 
+/* return route tolerance */
+u8   Settings::RouteTolerance(void) const { return route_tolerance; }
+
 /* return scroll speed */
 u8   Settings::ScrollSpeed(void) const { return scroll_speed; }
 
@@ -851,6 +868,12 @@ void Settings::SetAIMoveSpeed(u8 speed)
     ai_speed = (10 <= speed ? 10 : speed);
 }
 
+/* set route tolerance: 0 - 100 percent */
+void Settings::SetRouteTolerance(u8 tolerance)
+{
+    route_tolerance = (100 < tolerance ? 100 : tolerance);
+}
+
 /* set hero speed: 0 - 10 */
 void Settings::SetHeroesMoveSpeed(u8 speed)
 {
@@ -880,6 +903,7 @@ void Settings::SetScrollSpeed(u8 speed)
 bool Settings::QVGA(void) const { return video_mode.w && video_mode.h && (video_mode.w < 640 || video_mode.h < 480); }
 
 bool Settings::UseAltResource(void) const { return opt_global.Modes(GLOBAL_ALTRESOURCE); }
+bool Settings::UseMapsCache(void) const { return opt_global.Modes(GLOBAL_MAPSCACHE); }
 bool Settings::PriceLoyaltyVersion(void) const { return opt_global.Modes(GLOBAL_PRICELOYALTY); }
 bool Settings::LoadedGameVersion(void) const { return game_type & Game::TYPE_LOADFILE; }
 
@@ -1409,6 +1433,11 @@ bool Settings::ExtGameAutosaveOn(void) const
     return ExtModes(GAME_AUTOSAVE_ON);
 }
 
+bool Settings::ExtGameAutosaveDelta(void) const
+{
+    return ExtModes(GAME_AUTOSAVE_DELTA);
+}
+
 bool Settings::ExtGameUseFade(void) const
 {
     return video_mode.w == 640 && video_mode.h == 480 && ExtModes(GAME_USE_FADE);
@@ -1635,6 +1664,19 @@ u32 Settings::DisplayFlags(void) const
     return flags;
 }
 
+/* the maps cache key: the setup before the random races roll, without the game type, debug and interface */
+StreamBase & Settings::WriteMapsSetup(StreamBase & msg) const
+{
+    msg << current_maps_file << game_difficulty <<
+	opt_world << opt_battle << opt_addons << static_cast<u32>(players.size());
+
+    for(Players::const_iterator
+	it = players.begin(); it != players.end(); ++it)
+	msg << (*it)->color << (*it)->control << (*it)->GetSetupRace() << (*it)->friends;
+
+    return msg;
+}
+
 StreamBase & operator<< (StreamBase & msg, const Settings & conf)
 {
     return msg <<
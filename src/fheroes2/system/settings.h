@@ -39,9 +39,10 @@
 #include <android/log.h>
 #endif
 
+#define FORMAT_VERSION_2900 0x0B54
 #define FORMAT_VERSION_2850 0x0B22
 #define FORMAT_VERSION_2830 0x0B0E
-#define CURRENT_FORMAT_VERSION FORMAT_VERSION_2850
+#define CURRENT_FORMAT_VERSION FORMAT_VERSION_2900
 #define LAST_FORMAT_VERSION FORMAT_VERSION_2830
 
 enum
@@ -132,7 +133,7 @@ public:
 	GAME_EVIL_INTERFACE		= 0x10001000,
 	GAME_HIDE_INTERFACE		= 0x10002000,
 	GAME_ALSO_CONFIRM_AUTOSAVE	= 0x10004000,
-	//UNUSED			= 0x10008000,
+	GAME_AUTOSAVE_DELTA		= 0x10008000,
 	GAME_DYNAMIC_INTERFACE		= 0x10010000,
         GAME_BATTLE_SHOW_GRID		= 0x10020000,
         GAME_BATTLE_SHOW_MOUSE_SHADOW	= 0x10040000,
@@ -220,6 +221,7 @@ public:
     u8 BattleSpeed(void) const;
     u8 ScrollSpeed(void) const;
     u32 MemoryLimit(void) const;
+    u8 RouteTolerance(void) const;
 
     const std::string & PlayMusCommand(void) const;
     const std::string & SelectVideoDriver(void) const;
@@ -259,12 +261,14 @@ public:
     bool Unicode(void) const;
     bool PocketPC(void) const;
     bool UseAltResource(void) const;
+    bool UseMapsCache(void) const;
     bool PriceLoyaltyVersion(void) const;
     bool LoadedGameVersion(void) const;
     bool MusicExt(void) const;
     bool MusicMIDI(void) const;
     bool MusicCD(void) const;
     void BinarySave(void) const;
+    StreamBase & WriteMapsSetup(StreamBase &) const;
     void BinaryLoad(void);
 
     bool CanChangeInGame(u32) const;
@@ -334,6 +338,7 @@ public:
     bool ExtGameShowSystemInfo(void) const;
     bool ExtGameAutosaveBeginOfDay(void) const;
     bool ExtGameAutosaveOn(void) const;
+    bool ExtGameAutosaveDelta(void) const;
     bool ExtGameUseFade(void) const;
     bool ExtGameShowSDL(void) const;
     bool ExtGameEvilInterface(void) const;
@@ -375,6 +380,7 @@ public:
     void SetScrollSpeed(u8);
     void SetHeroesMoveSpeed(u8);
     void SetBattleSpeed(u8);
+    void SetRouteTolerance(u8);
 
     void SetSoundVolume(const u8 v);
     void SetMusicVolume(const u8 v);
@@ -485,6 +491,7 @@ private:
     u16 port;
 
     u32 memory_limit;
+    u8 route_tolerance;
 
     Point pos_radr;
     Point pos_bttn;
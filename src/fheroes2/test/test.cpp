@@ -20,6 +20,8 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
  ***************************************************************************/
 
+#include <new>
+#include <cstdlib>
 #include "agg.h"
 #include "settings.h"
 #include "gamedefs.h"
@@ -33,11 +35,51 @@
 
 #ifndef BUILD_RELEASE
 
+namespace Test
+{
+    bool alloc_counting = false;
+    u32  alloc_count = 0;
+}
+
+/* the test build: count the allocations of the test scope, see Test::AllocCounting */
+void* operator new(std::size_t size) throw(std::bad_alloc)
+{
+    if(Test::alloc_counting) ++Test::alloc_count;
+
+    void* ptr = std::malloc(size ? size : 1);
+    if(! ptr) throw std::bad_alloc();
+
+    return ptr;
+}
+
+void operator delete(void* ptr) throw()
+{
+    std::free(ptr);
+}
+
+void Test::AllocCounting(bool f)
+{
+    alloc_counting = f;
+}
+
+u32 Test::AllocCount(void)
+{
+    return alloc_count;
+}
+
 void RunTest1(void);
 void RunTest2(void);
 void RunTest3(void);
 
 void TestMonsterSprite(void);
+void TestBattleDamageCache(void);
+void TestBattleUnitsAlloc(void);
+void TestBattleSiege(void);
+void TestTilesStorage(void);
+void TestKingdomVisit(void);
+void TestMapsCache(void);
+void TestAIPlanning(void);
+void TestRouteHierarchy(void);
 
 void Test::Run(int num)
 {
@@ -48,6 +90,14 @@ void Test::Run(int num)
 	case 3: RunTest3(); break;
 
 	case 9: TestMonsterSprite(); break;
+	case 10: TestBattleDamageCache(); break;
+	case 11: TestBattleUnitsAlloc(); break;
+	case 12: TestBattleSiege(); break;
+	case 13: TestTilesStorage(); break;
+	case 14: TestKingdomVisit(); break;
+	case 15: TestMapsCache(); break;
+	case 16: TestAIPlanning(); break;
+	case 17: TestRouteHierarchy(); break;
 
 	default: DEBUG(DBG_ENGINE, DBG_WARN, "unknown test"); break;
     }
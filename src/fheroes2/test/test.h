@@ -25,9 +25,15 @@
 
 #ifndef BUILD_RELEASE
 
+#include "types.h"
+
 namespace Test
 {
     void Run(int);
+
+    /* heap allocations by operator new, counted while enabled */
+    void AllocCounting(bool);
+    u32  AllocCount(void);
 }
 
 #endif
@@ -0,0 +1,111 @@
+/***************************************************************************
+ *   Copyright (C) 2012 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+#include "settings.h"
+#include <cstdlib>
+#include <sstream>
+#include "settings.h"
+#include "world.h"
+#include "kingdom.h"
+#include "heroes.h"
+#include "maps_fileinfo.h"
+#include "ai.h"
+#include "test.h"
+
+#ifndef BUILD_RELEASE
+
+/* the planned tasks of all AI heroes */
+static std::string AIPlannedTasks(void)
+{
+    const Colors colors(Settings::Get().GetPlayers().GetColors(CONTROL_AI, true));
+    std::ostringstream os;
+
+    for(Colors::const_iterator
+	it = colors.begin(); it != colors.end(); ++it)
+    {
+	const KingdomHeroes & heroes = world.GetKingdom(*it).GetHeroes();
+
+	for(KingdomHeroes::const_iterator
+	    ith = heroes.begin(); ith != heroes.end(); ++ith)
+	    os << (*ith)->GetName() << std::endl << AI::HeroesString(**ith);
+    }
+
+    return os.str();
+}
+
+void TestAIPlanning(void)
+{
+    VERBOSE("Run TestAIPlanning");
+
+    Settings & conf = Settings::Get();
+    MapsFileInfoList lists;
+
+    if(! PrepareMapsFileInfoList(lists, false))
+    {
+	VERBOSE("TestAIPlanning: maps not found");
+	return;
+    }
+
+    const u32 seed = 2013;
+    u32 differ = 0;
+
+    for(MapsFileInfoList::const_iterator
+	it = lists.begin(); it != lists.end(); ++it)
+    {
+	conf.SetGameType(Game::TYPE_STANDARD);
+	conf.SetCurrentFileInfo(*it);
+
+	Players & players = conf.GetPlayers();
+	const Colors colors(players.GetColors());
+
+	// all kingdoms by the AI
+	for(Colors::const_iterator
+	    itc = colors.begin(); itc != colors.end(); ++itc)
+	    players.SetPlayerControl(*itc, CONTROL_AI);
+
+	players.SetStartGame();
+
+	std::srand(seed);
+	if(! world.ReadMaps((*it).file)) continue;
+
+	// the same world: the threads, then in order
+	SDL::Time time1, time2;
+
+	time1.Start();
+	AI::KingdomsPlan(true);
+	time1.Stop();
+	const std::string tasks1 = AIPlannedTasks();
+
+	time2.Start();
+	AI::KingdomsPlan(false);
+	time2.Stop();
+	const std::string tasks2 = AIPlannedTasks();
+
+	if(tasks1 != tasks2) ++differ;
+
+	VERBOSE("TestAIPlanning: " << (*it).file << ", threads: " << time1.Get() << "ms" <<
+	    ", serial: " << time2.Get() << "ms" << ", tasks: " << (tasks1 == tasks2 ? "equal" : "differ"));
+    }
+
+    VERBOSE("TestAIPlanning: maps: " << lists.size() << ", differ: " << differ);
+}
+
+#endif
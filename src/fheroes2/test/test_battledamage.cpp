@@ -0,0 +1,126 @@
+/***************************************************************************
+ *   Copyright (C) 2012 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "settings.h"
+#include "world.h"
+#include "army.h"
+#include "monster.h"
+#include "battle_arena.h"
+#include "battle_army.h"
+#include "battle_troop.h"
+
+#ifndef BUILD_RELEASE
+
+/* the damage without the cache */
+static Battle::DamageInfo CalculateDamage(const Battle::Unit & attacker, const Battle::Unit & defender)
+{
+    Battle::DamageInfo res;
+
+    res.min = attacker.CalculateDamageUnit(defender, attacker.ArmyTroop::GetDamageMin());
+    res.max = attacker.CalculateDamageUnit(defender, attacker.ArmyTroop::GetDamageMax());
+    res.expected = attacker.Modes(Battle::SP_BLESS) ? res.max :
+		(attacker.Modes(Battle::SP_CURSE) ? res.min : (res.min + res.max) / 2);
+
+    if(attacker.Modes(Battle::LUCK_GOOD)) res.expected *= 2;
+    else
+    if(attacker.Modes(Battle::LUCK_BAD)) res.expected /= 2;
+
+    res.killed = defender.HowManyWillKilled((res.min + res.max) / 2);
+
+    return res;
+}
+
+static u32 CheckDamageCache(Battle::Unit & attacker, Battle::Unit & defender)
+{
+    Battle::DamageCache* cache = Battle::Arena::GetDamageCache();
+    const Battle::DamageInfo expected = CalculateDamage(attacker, defender);
+
+    // twice: the second from the table
+    const Battle::DamageInfo info1 = cache->Get(attacker, defender);
+    const u32 hits = cache->GetHits();
+    const Battle::DamageInfo info2 = cache->Get(attacker, defender);
+
+    if(info1 == expected && info2 == expected && hits + 1 == cache->GetHits()) return 0;
+
+    VERBOSE("damage cache: " << attacker.String() << " -> " << defender.String() <<
+	", cached: " << info2.min << "-" << info2.max << ", " << info2.killed <<
+	", expected: " << expected.min << "-" << expected.max << ", " << expected.killed);
+
+    return 1;
+}
+
+void TestBattleDamageCache(void)
+{
+    VERBOSE("Run TestBattleDamageCache");
+
+    world.NewMaps(36, 36);
+
+    const s32 index = world.w() * world.h() / 2;
+    u32 errors = 0;
+    u32 count = 0;
+    u32 hits = 0;
+    u32 invalidated = 0;
+
+    for(u8 id1 = Monster::PEASANT; id1 <= Monster::WATER_ELEMENT; ++id1)
+	for(u8 id2 = Monster::PEASANT; id2 <= Monster::WATER_ELEMENT; ++id2)
+    {
+	Army army1, army2;
+
+	army1.JoinTroop(Monster(id1), 10);
+	army2.JoinTroop(Monster(id2), 10);
+
+	Battle::Arena arena(army1, army2, index, false);
+
+	Battle::Unit & attacker = *arena.GetForce1().front();
+	Battle::Unit & defender = *arena.GetForce2().front();
+
+	// default state
+	errors += CheckDamageCache(attacker, defender);
+	errors += CheckDamageCache(defender, attacker);
+
+	// spells and luck
+	attacker.SetModes(Battle::SP_BLESS | Battle::LUCK_GOOD);
+	defender.SetModes(Battle::SP_STONE | Battle::SP_SHIELD);
+	errors += CheckDamageCache(attacker, defender);
+
+	attacker.ResetModes(Battle::SP_BLESS | Battle::LUCK_GOOD);
+	attacker.SetModes(Battle::SP_CURSE | Battle::SP_BLIND);
+	defender.ResetModes(Battle::SP_STONE);
+	errors += CheckDamageCache(attacker, defender);
+
+	// losses: the table is filled, then invalidated
+	const Battle::DamageInfo before = Battle::Arena::GetDamageCache()->Get(attacker, defender);
+	defender.ApplyDamage(defender.GetHitPoints() / 2);
+	errors += CheckDamageCache(attacker, defender);
+	errors += CheckDamageCache(defender, attacker);
+
+	if(! (before == CalculateDamage(attacker, defender))) ++invalidated;
+
+	count += 6;
+	hits += Battle::Arena::GetDamageCache()->GetHits();
+    }
+
+    VERBOSE("TestBattleDamageCache: checks: " << count << ", errors: " << errors <<
+	", hits: " << hits << ", invalidated: " << invalidated);
+}
+
+#endif
@@ -0,0 +1,66 @@
+/***************************************************************************
+ *   Copyright (C) 2012 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <sstream>
+#include "settings.h"
+#include "monster.h"
+#include "skill.h"
+#include "game.h"
+
+#ifndef BUILD_RELEASE
+
+/* same armies: field battle and castle siege (walls, moat, turrets, catapult) */
+u32 RunBattleSiegeBenchmark(bool siege, u32 repeat)
+{
+    std::ostringstream batch;
+    std::ostringstream csv;
+
+    batch << "hero:1 attack:2 skill:" << static_cast<int>(Skill::Secondary::BALLISTICS) << ":" <<
+	static_cast<int>(Skill::Level::EXPERT) << " troop:" << static_cast<int>(Monster::ARCHER) << ":30 troop:" <<
+	static_cast<int>(Monster::SWORDSMAN) << ":20 troop:" << static_cast<int>(Monster::CAVALRY) << ":10 | " <<
+	"hero:20 defense:2 troop:" << static_cast<int>(Monster::ORC) << ":30 troop:" <<
+	static_cast<int>(Monster::WOLF) << ":15 troop:" << static_cast<int>(Monster::OGRE) << ":10 | " <<
+	"repeat:" << repeat << (siege ? " siege" : "") << std::endl;
+
+    std::istringstream is(batch.str());
+
+    SDL::Time time;
+    time.Start();
+    Game::BattleSimulation(is, csv);
+    time.Stop();
+
+    return time.Get();
+}
+
+void TestBattleSiege(void)
+{
+    VERBOSE("Run TestBattleSiege");
+
+    const u32 repeat = 50;
+    const u32 field = RunBattleSiegeBenchmark(false, repeat);
+    const u32 siege = RunBattleSiegeBenchmark(true, repeat);
+
+    VERBOSE("TestBattleSiege: battles: " << repeat << ", field: " << field << " ms, siege: " << siege << " ms" <<
+	", ratio: " << (field ? static_cast<float>(siege) / field : 0));
+}
+
+#endif
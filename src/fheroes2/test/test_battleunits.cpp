@@ -0,0 +1,129 @@
+/***************************************************************************
+ *   Copyright (C) 2012 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <cstdlib>
+#include <sstream>
+#include "settings.h"
+#include "world.h"
+#include "army.h"
+#include "monster.h"
+#include "kingdom.h"
+#include "battle_arena.h"
+#include "battle_army.h"
+#include "battle_troop.h"
+#include "test.h"
+
+#ifndef BUILD_RELEASE
+
+/* the heap allocations of a seeded battle: order queries and the turns */
+static void RunBattleUnits(s32 index, u32 seed, u32 & order_allocs, u32 & turn_allocs, u32 & turns, std::string & result)
+{
+    Army army1, army2;
+
+    army1.SetColor(Color::BLUE);
+    army1.JoinTroop(Monster(Monster::PIKEMAN), 20);
+    army1.JoinTroop(Monster(Monster::ARCHER), 15);
+    army1.JoinTroop(Monster(Monster::SWORDSMAN), 10);
+    army1.JoinTroop(Monster(Monster::CAVALRY), 5);
+    army1.JoinTroop(Monster(Monster::PALADIN), 2);
+
+    army2.SetColor(Color::RED);
+    army2.JoinTroop(Monster(Monster::GOBLIN), 40);
+    army2.JoinTroop(Monster(Monster::ORC), 20);
+    army2.JoinTroop(Monster(Monster::WOLF), 10);
+    army2.JoinTroop(Monster(Monster::OGRE), 6);
+    army2.JoinTroop(Monster(Monster::TROLL), 3);
+
+    std::srand(seed);
+
+    Battle::Arena arena(army1, army2, index, false);
+    Battle::Units order;
+
+    u32 start = Test::AllocCount();
+    Test::AllocCounting(true);
+
+    for(u32 ii = 0; ii < 1000; ++ii)
+    {
+	Battle::Force::GetCurrentUnit(arena.GetForce1(), arena.GetForce2(), NULL, &order, true);
+	arena.GetForce1().GetValidUnits();
+	arena.GetForce2().GetValidUnits();
+    }
+
+    Test::AllocCounting(false);
+    order_allocs = Test::AllocCount() - start;
+
+    turns = 0;
+    start = Test::AllocCount();
+    Test::AllocCounting(true);
+
+    while(arena.BattleValid() && turns < 100)
+    {
+	arena.Turns();
+	++turns;
+    }
+
+    Test::AllocCounting(false);
+    turn_allocs = Test::AllocCount() - start;
+
+    const Battle::Result & res = arena.GetResult();
+    std::ostringstream os;
+
+    os << "turns: " << turns << ", army1: " << static_cast<int>(res.army1) << ", army2: " << static_cast<int>(res.army2) <<
+	", killed: " << res.killed << ", dead1: " << arena.GetForce1().GetDeadHitPoints() <<
+	", dead2: " << arena.GetForce2().GetDeadHitPoints();
+    result = os.str();
+}
+
+void TestBattleUnitsAlloc(void)
+{
+    VERBOSE("Run TestBattleUnitsAlloc");
+
+    Settings & conf = Settings::Get();
+    Players & players = conf.GetPlayers();
+
+    world.NewMaps(36, 36);
+
+    players.Init(Color::BLUE | Color::RED);
+    players.SetPlayerControl(Color::BLUE, CONTROL_AI);
+    players.SetPlayerControl(Color::RED, CONTROL_AI);
+    world.GetKingdoms().Init();
+
+    const s32 index = world.w() * world.h() / 2;
+    const u32 seed = 2013;
+
+    u32 order1, order2, battle1, battle2, turns1, turns2;
+    std::string result1, result2;
+
+    // the same battle: the baseline without the pool, then with the pool
+    Battle::Units::SetPoolEnabled(false);
+    RunBattleUnits(index, seed, order1, battle1, turns1, result1);
+
+    Battle::Units::SetPoolEnabled(true);
+    RunBattleUnits(index, seed, order2, battle2, turns2, result2);
+
+    VERBOSE("TestBattleUnitsAlloc: " << result1 << ", with pool: " << (result1 == result2 ? "equal" : "differ"));
+    VERBOSE("TestBattleUnitsAlloc: unit order allocations (1000 calls), without pool: " << order1 << ", with pool: " << order2 <<
+	"; allocations per turn, without pool: " << (turns1 ? battle1 / turns1 : 0) << ", with pool: " << (turns2 ? battle2 / turns2 : 0) <<
+	", reduced: " << (order2 < order1 && battle2 <= battle1 ? "yes" : "no"));
+}
+
+#endif
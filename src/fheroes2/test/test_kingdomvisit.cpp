@@ -0,0 +1,143 @@
+/***************************************************************************
+ *   Copyright (C) 2012 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <list>
+#include <algorithm>
+#include <functional>
+#include "settings.h"
+#include "maps.h"
+#include "pairs.h"
+#include "visit.h"
+#include "mp2.h"
+#include "test.h"
+
+#ifndef BUILD_RELEASE
+
+namespace
+{
+    /* the reference: the visit list scan, as Kingdom before VisitObjects */
+    struct VisitList : public std::list<IndexObject>
+    {
+	bool isVisited(s32 index, u8 object) const
+	{
+	    const_iterator it = std::find_if(begin(), end(), std::bind2nd(std::mem_fun_ref(&IndexObject::isIndex), index));
+	    return end() != it && (*it).isObject(object);
+	}
+
+	u16 Count(u8 object) const
+	{
+	    return std::count_if(begin(), end(), std::bind2nd(std::mem_fun_ref(&IndexObject::isObject), object));
+	}
+    };
+
+    const MP2::object_t objects[] = { MP2::OBJ_WINDMILL, MP2::OBJ_WATERWHEEL, MP2::OBJ_MAGICWELL,
+	MP2::OBJ_ARTESIANSPRING, MP2::OBJ_OBELISK, MP2::OBJ_STANDINGSTONES, MP2::OBJ_WITCHSHUT };
+
+    u32 CompareVisits(const VisitObjects & visits, const VisitList & reference, s32 count)
+    {
+	u32 errors = 0;
+
+	for(s32 index = 0; index < count; ++index)
+	    for(u8 ii = 0; ii < ARRAY_COUNT(objects); ++ii)
+		if(visits.isVisited(index, objects[ii]) != reference.isVisited(index, objects[ii])) ++errors;
+
+	for(u8 ii = 0; ii < ARRAY_COUNT(objects); ++ii)
+	    if(visits.Count(objects[ii]) != reference.Count(objects[ii]) ||
+		visits.isVisited(objects[ii]) != (0 < reference.Count(objects[ii]))) ++errors;
+
+	return errors;
+    }
+
+    template<typename Visits>
+    u32 QueryVisits(const Visits & visits, s32 count)
+    {
+	u32 found = 0;
+
+	// AI scan: every tile with every object
+	for(s32 index = 0; index < count; ++index)
+	    for(u8 ii = 0; ii < ARRAY_COUNT(objects); ++ii)
+		if(visits.isVisited(index, objects[ii])) ++found;
+
+	for(u32 pass = 0; pass < 10000; ++pass)
+	    found += visits.Count(objects[pass % ARRAY_COUNT(objects)]);
+
+	return found;
+    }
+}
+
+void TestKingdomVisit(void)
+{
+    VERBOSE("Run TestKingdomVisit");
+
+    const s32 count = Maps::XLARGE * Maps::XLARGE;
+    VisitObjects visits;
+    VisitList reference;
+
+    // a long game: the most visitable objects on the map
+    u32 visited = 0;
+    for(s32 index = 0; index < count; index += 3)
+    {
+	const IndexObject visit(index, objects[index % ARRAY_COUNT(objects)]);
+	visits.push_front(visit);
+	reference.push_front(visit);
+	++visited;
+    }
+
+    // visited twice, the other object: the last visit wins
+    for(s32 index = 0; index < count; index += 15)
+    {
+	const IndexObject visit(index, objects[(index + 1) % ARRAY_COUNT(objects)]);
+	visits.push_front(visit);
+	reference.push_front(visit);
+	++visited;
+    }
+
+    u32 errors = CompareVisits(visits, reference, count);
+
+    if(! visits.isVisited(0, objects[1]) || visits.isVisited(0, objects[0]))
+	++errors;
+
+    SDL::Time time;
+
+    time.Start();
+    const u32 found = QueryVisits(visits, count);
+    time.Stop();
+    const u32 visits_ms = time.Get();
+
+    time.Start();
+    const u32 reference_found = QueryVisits(reference, count);
+    time.Stop();
+    const u32 reference_ms = time.Get();
+
+    if(found != reference_found) ++errors;
+
+    // week expiry: the older visit of the tile is found again
+    visits.remove_if(Visit::isWeekLife);
+    reference.remove_if(Visit::isWeekLife);
+    errors += CompareVisits(visits, reference, count);
+
+    VERBOSE("TestKingdomVisit: visited: " << visited << ", queries: " << count * ARRAY_COUNT(objects) + 10000 <<
+	", index: " << visits_ms << "ms" << ", list: " << reference_ms << "ms" <<
+	", found: " << found << ", errors: " << errors);
+}
+
+#endif
@@ -0,0 +1,86 @@
+/***************************************************************************
+ *   Copyright (C) 2012 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+#include "settings.h"
+#include "world.h"
+#include "maps_fileinfo.h"
+#include "game_io.h"
+#include "tools.h"
+#include "test.h"
+
+#ifndef BUILD_RELEASE
+
+static u32 WorldCheckSum(void)
+{
+    StreamBuf sb(0);
+    sb << World::Get();
+    return CheckSum(sb.data(), sb.size());
+}
+
+void TestMapsCache(void)
+{
+    VERBOSE("Run TestMapsCache");
+
+    Settings & conf = Settings::Get();
+    MapsFileInfoList lists;
+
+    if(! PrepareMapsFileInfoList(lists, false))
+    {
+	VERBOSE("TestMapsCache: maps not found");
+	return;
+    }
+
+    const std::string & amap = lists.front().file;
+
+    conf.SetGameType(Game::TYPE_STANDARD);
+    conf.SetCurrentFileInfo(lists.front());
+    conf.GetPlayers().SetStartGame();
+
+    const u32 key = Game::MapsCacheKey(amap);
+
+    // full parse, then the cache from the same world
+    SDL::Time time1, time2;
+
+    time1.Start();
+    const bool parsed = world.ReadMaps(amap);
+    time1.Stop();
+
+    const u32 crc1 = WorldCheckSum();
+
+    if(! parsed || ! Game::SaveMapsCache(amap, key))
+    {
+	VERBOSE("TestMapsCache: " << amap << ", write: error");
+	return;
+    }
+
+    time2.Start();
+    const bool cached = Game::LoadMapsCache(amap, key);
+    time2.Stop();
+
+    const u32 crc2 = WorldCheckSum();
+
+    VERBOSE("TestMapsCache: " << amap << ", parse: " << time1.Get() << "ms" <<
+	", cache: " << time2.Get() << "ms" << ", loaded: " << (cached ? "yes" : "no") <<
+	", world: " << (crc1 == crc2 ? "equal" : "differ") <<
+	", other key: " << (Game::LoadMapsCache(amap, key + 1) ? "loaded" : "rejected"));
+}
+
+#endif
@@ -0,0 +1,137 @@
+/***************************************************************************
+ *   Copyright (C) 2012 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+#include "settings.h"
+#include <cstdlib>
+#include "settings.h"
+#include "world.h"
+#include "kingdom.h"
+#include "heroes.h"
+#include "maps.h"
+#include "maps_fileinfo.h"
+#include "route.h"
+#include "test.h"
+
+#ifndef BUILD_RELEASE
+
+static const Heroes* FirstKingdomHeroes(void)
+{
+    const Colors colors(Settings::Get().GetPlayers().GetColors());
+
+    for(Colors::const_iterator
+	it = colors.begin(); it != colors.end(); ++it)
+    {
+	const KingdomHeroes & heroes = world.GetKingdom(*it).GetHeroes();
+	if(heroes.size()) return heroes.front();
+    }
+
+    return NULL;
+}
+
+void TestRouteHierarchy(void)
+{
+    VERBOSE("Run TestRouteHierarchy");
+
+    Settings & conf = Settings::Get();
+    MapsFileInfoList lists;
+
+    if(! PrepareMapsFileInfoList(lists, false))
+    {
+	VERBOSE("TestRouteHierarchy: maps not found");
+	return;
+    }
+
+    const u8 tolerance = 10;
+    const u32 seed = 2013;
+    u32 routes = 0;
+    u32 exceeded = 0;
+    u32 mismatch = 0;
+    u32 worst = 100;
+
+    for(MapsFileInfoList::const_iterator
+	it = lists.begin(); it != lists.end(); ++it)
+    {
+	// the hierarchy is enabled for the big maps only
+	if(Maps::XLARGE > (*it).size_w) continue;
+
+	conf.SetGameType(Game::TYPE_STANDARD);
+	conf.SetCurrentFileInfo(*it);
+	conf.GetPlayers().SetStartGame();
+
+	std::srand(seed);
+	if(! world.ReadMaps((*it).file)) continue;
+
+	const Heroes* hero = FirstKingdomHeroes();
+	if(! hero) continue;
+
+	SDL::Time time;
+	u32 time1 = 0;
+	u32 time2 = 0;
+	u32 count = 0;
+
+	for(u32 ii = 0; ii < 100; ++ii)
+	{
+	    const s32 to = std::rand() % (world.w() * world.h());
+	    Route::Path path(*hero);
+
+	    // the same destination: the hierarchy, then the flat search
+	    conf.SetRouteTolerance(tolerance);
+	    time.Start();
+	    const bool found1 = path.Calculate(to);
+	    time.Stop();
+	    time1 += time.Get();
+	    const u32 cost1 = path.GetTotalPenalty();
+
+	    conf.SetRouteTolerance(0);
+	    time.Start();
+	    const bool found2 = path.Calculate(to);
+	    time.Stop();
+	    time2 += time.Get();
+	    const u32 cost2 = path.GetTotalPenalty();
+
+	    if(found1 != found2)
+	    {
+		VERBOSE("TestRouteHierarchy: " << (*it).file << ", to: " << to <<
+		    ", found: " << (found1 ? "hierarchy" : "flat"));
+		++mismatch;
+		continue;
+	    }
+
+	    if(! found2 || 0 == cost2) continue;
+
+	    const u32 ratio = 100 * cost1 / cost2;
+	    if(ratio > worst) worst = ratio;
+	    if(100 * cost1 > cost2 * (100 + tolerance)) ++exceeded;
+
+	    ++count;
+	}
+
+	routes += count;
+
+	VERBOSE("TestRouteHierarchy: " << (*it).file << ", routes: " << count <<
+	    ", hierarchy: " << time1 << "ms" << ", flat: " << time2 << "ms");
+    }
+
+    VERBOSE("TestRouteHierarchy: routes: " << routes << ", tolerance: " << static_cast<int>(tolerance) <<
+	"%, worst: " << worst << "%, exceeded: " << exceeded << ", mismatch: " << mismatch);
+}
+
+#endif
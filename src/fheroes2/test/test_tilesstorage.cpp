@@ -0,0 +1,196 @@
+/***************************************************************************
+ *   Copyright (C) 2012 by Andrey Afletdinov <fheroes2@gmail.com>          *
+ *                                                                         *
+ *   Part of the Free Heroes2 Engine:                                      *
+ *   http://sourceforge.net/projects/fheroes2                              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <list>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include "settings.h"
+#include "world.h"
+#include "maps_tiles.h"
+#include "mp2.h"
+#include "test.h"
+
+#ifndef BUILD_RELEASE
+
+namespace
+{
+    u32 list_blocks = 0;
+    u32 list_bytes = 0;
+
+    /* the baseline: list nodes, counted */
+    template<typename T>
+    struct CountAllocator : public std::allocator<T>
+    {
+	template<typename U> struct rebind { typedef CountAllocator<U> other; };
+
+	CountAllocator() {}
+	CountAllocator(const CountAllocator &) : std::allocator<T>() {}
+	template<typename U> CountAllocator(const CountAllocator<U> &) {}
+
+	T* allocate(size_t n, const void* = 0)
+	{
+	    list_blocks += 1;
+	    list_bytes += n * sizeof(T);
+	    return std::allocator<T>::allocate(n);
+	}
+
+	void deallocate(T* p, size_t n)
+	{
+	    list_blocks -= 1;
+	    list_bytes -= n * sizeof(T);
+	    std::allocator<T>::deallocate(p, n);
+	}
+    };
+
+    typedef std::list<Maps::TilesAddon, CountAllocator<Maps::TilesAddon> > AddonsList;
+
+    /* typical maps density: the most tiles without addons, some with the objects stack */
+    u8 AddonsLevel1(s32 index)
+    {
+	return index % 7 < 2 ? index % 4 : 0;
+    }
+
+    u8 AddonsLevel2(s32 index)
+    {
+	return index % 11 == 0 ? 1 : 0;
+    }
+
+    bool AddonsEqual(const Maps::TilesAddon & ta1, const Maps::TilesAddon & ta2)
+    {
+	return ta1.level == ta2.level && ta1.uniq == ta2.uniq &&
+	    ta1.object == ta2.object && ta1.index == ta2.index && ta1.tmp == ta2.tmp;
+    }
+
+    template<typename Container>
+    u32 SweepAddons(const std::vector<Container> & tiles)
+    {
+	u32 found = 0;
+
+	for(u8 pass = 0; pass < 100; ++pass)
+	    for(typename std::vector<Container>::const_iterator
+		it = tiles.begin(); it != tiles.end(); ++it)
+	{
+	    if((*it).end() != std::find_if((*it).begin(), (*it).end(), Maps::TilesAddon::isMine)) ++found;
+	    if((*it).end() != std::find_if((*it).begin(), (*it).end(),
+		    std::bind2nd(std::mem_fun_ref(&Maps::TilesAddon::isUniq), 0))) ++found;
+	}
+
+	return found;
+    }
+}
+
+void TestTilesStorage(void)
+{
+    VERBOSE("Run TestTilesStorage");
+
+    world.NewMaps(Maps::XLARGE3, Maps::XLARGE3);
+
+    const s32 count = world.w() * world.h();
+    u32 addons = 0;
+
+    for(s32 index = 0; index < count; ++index)
+    {
+	Maps::Tiles & tile = world.GetTiles(index);
+
+	for(u8 ii = 0; ii < AddonsLevel1(index); ++ii)
+	    tile.AddonsPushLevel1(Maps::TilesAddon(ii, World::GetUniq(), 0x38, ii));
+
+	for(u8 ii = 0; ii < AddonsLevel2(index); ++ii)
+	    tile.AddonsPushLevel2(Maps::TilesAddon(Maps::TilesAddon::UPPER, World::GetUniq(), 0x38, ii));
+
+	tile.AddonsSort();
+	addons += AddonsLevel1(index) + AddonsLevel2(index);
+    }
+
+    // the same addons: the list baseline and the arena
+    const u32 arena_used = Maps::Addons::GetArenaUsed();
+    const u32 arena_reserved = Maps::Addons::GetArenaReserved();
+    std::vector<AddonsList> list_tiles(count);
+    std::vector<Maps::Addons> arena_tiles(count);
+
+    for(s32 index = 0; index < count; ++index)
+	for(u8 ii = 0; ii < AddonsLevel1(index); ++ii)
+    {
+	const Maps::TilesAddon ta(ii, index, 0x38, ii);
+	list_tiles[index].push_back(ta);
+	arena_tiles[index].push_back(ta);
+    }
+
+    for(s32 index = 0; index < count; ++index)
+    {
+	arena_tiles[index].Shrink();
+
+	if(list_tiles[index].size() != arena_tiles[index].size() ||
+	    ! std::equal(arena_tiles[index].begin(), arena_tiles[index].end(), list_tiles[index].begin(),
+		    AddonsEqual))
+	{
+	    VERBOSE("TestTilesStorage: " << "addons differ, index: " << index);
+	    return;
+	}
+    }
+
+    SDL::Time time;
+    u32 found = 0;
+
+    // full map sweeps: objects and addons
+    time.Start();
+
+    for(u8 pass = 0; pass < 100; ++pass)
+	for(s32 index = 0; index < count; ++index)
+    {
+	const Maps::Tiles & tile = world.GetTiles(index);
+
+	if(MP2::OBJ_ZERO != tile.GetObject()) ++found;
+	if(tile.FindObjectConst(MP2::OBJ_MINES)) ++found;
+    }
+
+    time.Stop();
+    const u32 world_ms = time.Get();
+
+    time.Start();
+    const u32 list_found = SweepAddons(list_tiles);
+    time.Stop();
+    const u32 list_ms = time.Get();
+
+    time.Start();
+    const u32 arena_found = SweepAddons(arena_tiles);
+    time.Stop();
+    const u32 arena_ms = time.Get();
+
+    if(list_found != arena_found)
+	VERBOSE("TestTilesStorage: " << "sweeps differ: " << list_found << ", " << arena_found);
+
+    VERBOSE("TestTilesStorage: tiles: " << count << ", addons: " << addons <<
+	", tile size: " << sizeof(Maps::Tiles) << ", 100 sweeps: " << world_ms << "ms" << ", found: " << found);
+
+    VERBOSE("TestTilesStorage: list: " << "header: " << sizeof(AddonsList) <<
+	", tile size: " << sizeof(Maps::Tiles) - 2 * sizeof(Maps::Addons) + 2 * sizeof(AddonsList) <<
+	", heap blocks: " << list_blocks << ", heap bytes: " << list_bytes << ", 100 sweeps: " << list_ms << "ms");
+
+    VERBOSE("TestTilesStorage: arena: " << "header: " << sizeof(Maps::Addons) <<
+	", tile size: " << sizeof(Maps::Tiles) <<
+	", used bytes: " << Maps::Addons::GetArenaUsed() - arena_used <<
+	", reserved bytes: " << Maps::Addons::GetArenaReserved() - arena_reserved << ", 100 sweeps: " << arena_ms << "ms");
+}
+
+#endif